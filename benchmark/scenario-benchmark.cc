@@ -0,0 +1,308 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Performance benchmark of the q1, q2 and q3 scenarios.
+//
+// Each scenario is run over the cartesian product of the scale axes it
+// supports (q1 only has pcap; q2 adds offered load, simulation time, RTS and
+// the event scheduler; q3 adds the number of stations), with --profile so
+// that it reports its setup and run time and the number of events executed.
+// The peak resident set size is read from the rusage of the child. One CSV
+// row is written per run:
+//
+//   program,scenario,nStations,dataRate,simulationTime,pcap,enableRts,scheduler,
+//   repeat,exitCode,wallSeconds,startupSeconds,setupSeconds,runSeconds,events,
+//   eventsPerSecond,simulatedPerWallSecond,peakRssMb
+//
+// where eventsPerSecond and simulatedPerWallSecond are relative to the run
+// time, and wallSeconds also covers loading the process and tearing down.
+// startupSeconds is the time from the fork to the top of main() of the
+// scenario: loading the shared libraries and registering their TypeIds.
+// Axes that do not apply to a scenario are left empty. The program column
+// holds the file name of the executable, e.g. ns3.45-q3-default, so that
+// tables of different ns-3 builds can be told apart.
+//
+//   ./ns3 run "scenario-benchmark --stations=2,8,32 --simulationTime=5
+//              --repeat=3 --output=benchmark.csv"
+//
+// The scaling of the event schedulers is compared with e.g.
+//
+//   ./ns3 run "scenario-benchmark --scenarios=q3 --stations=8,64,256
+//              --dataRate=10Mbps,100Mbps --pcap=0 --enableRts=1
+//              --scheduler=map,heap,calendar,priority,radix"
+//
+// and their raw insert and remove rates with scheduler-benchmark.
+//
+// Runs are sequential by default: concurrent runs compete for caches and
+// memory bandwidth and write their pcap files to the same names.
+
+#include "../common/process-pool.h"
+#include "../common/scenario-profile.h"
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ScenarioBenchmark");
+
+namespace
+{
+
+/// Scale axes accepted by a scenario
+struct ScenarioAxes
+{
+    bool stations;       //!< Whether --nStations is accepted
+    bool dataRate;       //!< Whether --dataRate is accepted
+    bool simulationTime; //!< Whether --simulationTime is accepted
+    bool enableRts;      //!< Whether --enableRts is accepted
+    bool scheduler;      //!< Whether --scheduler is accepted
+};
+
+/// Axes of the benchmarked scenarios; every scenario accepts --pcap
+const std::map<std::string, ScenarioAxes> SCENARIOS = {
+    {"q1", {false, false, false, false, false}},
+    {"q2", {false, true, true, true, true}},
+    {"q3", {true, true, true, true, true}},
+};
+
+/// One benchmarked run; the axes that do not apply are empty
+struct BenchmarkCase
+{
+    std::string scenario;       //!< Scenario name
+    std::string nStations;      //!< Number of stations
+    std::string dataRate;       //!< Offered load per station
+    std::string simulationTime; //!< Simulation time in seconds
+    bool pcap;                  //!< PCAP tracing
+    std::string enableRts;      //!< RTS/CTS, 0 or 1
+    std::string scheduler;      //!< Event scheduler
+    uint32_t repeat;            //!< Repetition index
+};
+
+/**
+ * Split a comma separated list.
+ *
+ * @param list the list
+ * @return the non-empty items
+ */
+std::vector<std::string>
+Split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @param values the values of an axis
+ * @param applies whether the axis applies to the scenario
+ * @return @p values, or a single empty value if the axis does not apply
+ */
+std::vector<std::string>
+AxisValues(const std::vector<std::string>& values, bool applies)
+{
+    return applies ? values : std::vector<std::string>{""};
+}
+
+/**
+ * @param value "0", "1", "true" or "false"
+ * @return the boolean
+ */
+bool
+ParseBool(const std::string& value)
+{
+    NS_ABORT_MSG_UNLESS(value == "0" || value == "1" || value == "true" || value == "false",
+                        "Invalid boolean '" << value << "'");
+    return value == "1" || value == "true";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string scenarios = "q1,q2,q3"; /* Scenarios to benchmark */
+    std::string stations = "2,8"; /* Numbers of stations (q3) */
+    std::string dataRate = "100Mbps"; /* Offered loads per station (q2, q3) */
+    std::string simulationTime = "4"; /* Simulation times in seconds (q2, q3) */
+    std::string pcap = "0,1"; /* PCAP tracing settings */
+    std::string enableRts = "0,1"; /* RTS/CTS settings (q2, q3) */
+    std::string scheduler = "map"; /* Event schedulers (q2, q3) */
+    uint32_t repeat = 1; /* Runs of every configuration */
+    unsigned jobs = 1; /* Concurrent runs */
+    std::string output; /* CSV file, standard output if empty */
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scenarios", "Scenarios to benchmark, e.g. q1,q2,q3", scenarios);
+    cmd.AddValue("stations", "Numbers of stations of q3, e.g. 2,8,32", stations);
+    cmd.AddValue("dataRate", "Offered loads per station of q2 and q3, e.g. 10Mbps,100Mbps",
+                 dataRate);
+    cmd.AddValue("simulationTime", "Simulation times in seconds of q2 and q3, e.g. 4,20",
+                 simulationTime);
+    cmd.AddValue("pcap", "PCAP tracing settings, e.g. 0,1", pcap);
+    cmd.AddValue("enableRts", "RTS/CTS settings of q2 and q3, e.g. 0,1", enableRts);
+    cmd.AddValue("scheduler",
+                 "Event schedulers of q2 and q3, e.g. map,heap,calendar,priority,radix",
+                 scheduler);
+    cmd.AddValue("repeat", "Number of runs of every configuration", repeat);
+    cmd.AddValue("jobs",
+                 "Number of concurrent runs (0 for one per core); more than one skews the timings",
+                 jobs);
+    cmd.AddValue("output", "CSV file for the measurements (standard output if empty)", output);
+    cmd.Parse(argc, argv);
+
+    std::vector<std::string> stationValues = Split(stations);
+    std::vector<std::string> dataRateValues = Split(dataRate);
+    std::vector<std::string> timeValues = Split(simulationTime);
+    std::vector<bool> pcapValues;
+    for (const auto& value : Split(pcap))
+    {
+        pcapValues.push_back(ParseBool(value));
+    }
+    std::vector<std::string> rtsValues;
+    for (const auto& value : Split(enableRts))
+    {
+        rtsValues.push_back(ParseBool(value) ? "1" : "0");
+    }
+    std::vector<std::string> schedulerValues = Split(scheduler);
+
+    std::map<std::string, std::string> programs;
+    std::vector<BenchmarkCase> cases;
+    for (const auto& scenario : Split(scenarios))
+    {
+        auto axes = SCENARIOS.find(scenario);
+        NS_ABORT_MSG_IF(axes == SCENARIOS.end(), "Unknown scenario '" << scenario << "'");
+        std::string program = GetSiblingExecutable("scenario-benchmark", scenario, "..");
+        NS_ABORT_MSG_IF(program.empty() || access(program.c_str(), X_OK) != 0,
+                        "Cannot execute the " << scenario << " scenario '" << program << "'");
+        programs[scenario] = program;
+
+        for (const auto& n : AxisValues(stationValues, axes->second.stations))
+        {
+            for (const auto& rate : AxisValues(dataRateValues, axes->second.dataRate))
+            {
+                for (const auto& time : AxisValues(timeValues, axes->second.simulationTime))
+                {
+                    for (bool tracing : pcapValues)
+                    {
+                        for (const auto& rts : AxisValues(rtsValues, axes->second.enableRts))
+                        {
+                            for (const auto& s :
+                                 AxisValues(schedulerValues, axes->second.scheduler))
+                            {
+                                for (uint32_t r = 0; r < repeat; ++r)
+                                {
+                                    cases.push_back({scenario, n, rate, time, tracing, rts, s, r});
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    NS_ABORT_MSG_IF(cases.empty(), "Nothing to benchmark");
+
+    std::vector<std::vector<std::string>> commands;
+    commands.reserve(cases.size());
+    for (const auto& c : cases)
+    {
+        std::vector<std::string> command{programs[c.scenario], "--profile=1"};
+        command.push_back(std::string("--pcap=") + (c.pcap ? "1" : "0"));
+        if (!c.nStations.empty())
+        {
+            command.push_back("--nStations=" + c.nStations);
+        }
+        if (!c.dataRate.empty())
+        {
+            command.push_back("--dataRate=" + c.dataRate);
+        }
+        if (!c.simulationTime.empty())
+        {
+            command.push_back("--simulationTime=" + c.simulationTime);
+        }
+        if (!c.enableRts.empty())
+        {
+            command.push_back("--enableRts=" + c.enableRts);
+        }
+        if (!c.scheduler.empty())
+        {
+            command.push_back("--scheduler=" + c.scheduler);
+        }
+        commands.push_back(std::move(command));
+    }
+
+    std::size_t done = 0;
+    auto results =
+        RunProcessPool(commands, jobs, [&](std::size_t index, const ProcessResult& result) {
+            std::cerr << "[" << ++done << "/" << commands.size() << "] " << cases[index].scenario
+                      << (result.exitCode == 0 ? " done in " : " FAILED after ")
+                      << result.wallSeconds << " s\n";
+        });
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_UNLESS(file, "Cannot open " << output);
+    }
+    std::ostream& table = output.empty() ? std::cout : file;
+    table << "program,scenario,nStations,dataRate,simulationTime,pcap,enableRts,scheduler,"
+             "repeat,exitCode,wallSeconds,startupSeconds,setupSeconds,runSeconds,events,"
+             "eventsPerSecond,simulatedPerWallSecond,peakRssMb\n";
+
+    int failures = 0;
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        const auto& c = cases[i];
+        const auto& result = results[i];
+        const auto& program = programs[c.scenario];
+        table << program.substr(program.rfind('/') + 1) << "," << c.scenario << ","
+              << c.nStations << "," << c.dataRate << "," << c.simulationTime << "," << c.pcap
+              << "," << c.enableRts << "," << c.scheduler << "," << c.repeat << ","
+              << result.exitCode << "," << result.wallSeconds << ",";
+
+        ProfileReport report;
+        if (result.exitCode != 0 || !ParseProfileReport(result.output, report))
+        {
+            ++failures;
+            std::cerr << "Run " << i << " failed (exit code " << result.exitCode
+                      << "), output:\n"
+                      << result.output << "\n";
+            table << ",,,,,," << result.peakRssKb / 1024.0 << "\n";
+            continue;
+        }
+        double run = report.runSeconds > 0 ? report.runSeconds : 1e-9;
+        if (report.mainTime > 0)
+        {
+            table << report.mainTime - result.startTime;
+        }
+        table << "," << report.setupSeconds << "," << report.runSeconds << "," << report.events << ","
+              << report.events / run << "," << report.simulatedSeconds / run << ","
+              << result.peakRssKb / 1024.0 << "\n";
+    }
+    table.flush();
+
+    std::cerr << cases.size() - failures << " of " << cases.size() << " runs succeeded\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Insert and remove rates of the event schedulers.
+//
+// For every scheduler and number of pending events, the scheduler is filled
+// with that many events, then runs the hold model (remove the earliest
+// event, insert one a random delay later, as a simulation with a constant
+// event population does), then is drained. The delays are exponential; a
+// fraction of them is zero, as for the events scheduled for the current
+// time. One CSV row is written per measurement:
+//
+//   scheduler,pending,insertsPerSecond,holdsPerSecond,removesPerSecond
+//
+//   ./ns3 run "scheduler-benchmark --pending=1000,100000 --holds=10000000"
+//
+// The random delays are drawn before the timing, and every scheduler sees
+// the same ones.
+
+#include "../common/radix-heap-scheduler.h"
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/object-factory.h"
+#include "ns3/scheduler.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/**
+ * Split a comma separated list.
+ *
+ * @param list the list
+ * @return the non-empty items
+ */
+std::vector<std::string>
+Split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @param start the start of the measurement
+ * @param operations the number of operations measured
+ * @return the operations per second since @p start
+ */
+double
+GetRate(std::chrono::steady_clock::time_point start, uint64_t operations)
+{
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return operations / (seconds > 0 ? seconds : 1e-9);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string schedulers = "map,heap,calendar,priority,radix"; /* Schedulers to measure */
+    std::string pending = "100,1000,10000,100000"; /* Numbers of pending events */
+    uint64_t holds = 1000000; /* Hold operations per measurement */
+    double meanDelay = 100; /* Mean delay of the events in us */
+    double zeroDelay = 0.1; /* Fraction of events scheduled now */
+    uint32_t seed = 1; /* Seed of the delays */
+    std::string output; /* CSV file, standard output if empty */
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("schedulers",
+                 "Schedulers to measure: map, heap, list, calendar, priority, radix or TypeIds",
+                 schedulers);
+    cmd.AddValue("pending", "Numbers of pending events, e.g. 1000,100000", pending);
+    cmd.AddValue("holds", "Number of hold operations of every measurement", holds);
+    cmd.AddValue("meanDelay", "Mean delay in microseconds of the scheduled events", meanDelay);
+    cmd.AddValue("zeroDelay", "Fraction of the events scheduled for the current time", zeroDelay);
+    cmd.AddValue("seed", "Seed of the random delays", seed);
+    cmd.AddValue("output", "CSV file for the measurements (standard output if empty)", output);
+    cmd.Parse(argc, argv);
+
+    std::vector<uint64_t> sizes;
+    for (const auto& value : Split(pending))
+    {
+        sizes.push_back(std::stoull(value));
+    }
+    NS_ABORT_MSG_IF(sizes.empty() || holds == 0, "Nothing to measure");
+    NS_ABORT_MSG_IF(meanDelay <= 0 || zeroDelay < 0 || zeroDelay > 1, "Invalid delays");
+
+    // Timestamps are in ns, as in the scenarios
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> exponential(1 / (meanDelay * 1000));
+    std::bernoulli_distribution now(zeroDelay);
+    std::vector<uint64_t> delays(1 << 20);
+    for (auto& delay : delays)
+    {
+        delay = now(rng) ? 0 : static_cast<uint64_t>(exponential(rng));
+    }
+    const std::size_t mask = delays.size() - 1;
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_UNLESS(file, "Cannot open " << output);
+    }
+    std::ostream& table = output.empty() ? std::cout : file;
+    table << "scheduler,pending,insertsPerSecond,holdsPerSecond,removesPerSecond\n";
+
+    for (const auto& name : Split(schedulers))
+    {
+        ObjectFactory factory;
+        factory.SetTypeId(GetSchedulerTypeName(name));
+        for (uint64_t size : sizes)
+        {
+            Ptr<Scheduler> scheduler = factory.Create<Scheduler>();
+            Scheduler::Event ev{nullptr, {0, 0, 0}};
+            uint32_t uid = 0;
+            std::size_t next = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                ev.key.m_ts = delays[next++ & mask];
+                ev.key.m_uid = uid++;
+                scheduler->Insert(ev);
+            }
+            double inserts = GetRate(start, size);
+
+            start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < holds; ++i)
+            {
+                ev = scheduler->RemoveNext();
+                ev.key.m_ts += delays[next++ & mask];
+                ev.key.m_uid = uid++;
+                scheduler->Insert(ev);
+            }
+            double holdRate = GetRate(start, holds);
+
+            start = std::chrono::steady_clock::now();
+            uint64_t last = 0;
+            while (!scheduler->IsEmpty())
+            {
+                ev = scheduler->RemoveNext();
+                NS_ABORT_MSG_IF(ev.key.m_ts < last, name << " removed events out of order");
+                last = ev.key.m_ts;
+            }
+            double removes = GetRate(start, size);
+
+            table << name << "," << size << "," << inserts << "," << holdRate << "," << removes
+                  << std::endl;
+        }
+    }
+    return 0;
+}
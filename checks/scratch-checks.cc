@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Self-checks of the code shared by the scenarios and the tools, for what
+// the scenario outputs do not show directly. Each check prints PASS or FAIL
+// with its failures, and the exit code is 1 if any check failed.
+//
+//   ./ns3 run "scratch-checks"
+
+#include "../common/capture-writer.h"
+#include "../common/station-layout.h"
+#include "../pcap-analyzer/wifi-frame.h"
+
+#include "ns3/he-phy.h"
+#include "ns3/vht-phy.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/**
+ * Write the radiotap header of a TXVECTOR and decode it as pcap-analyzer does.
+ *
+ * @param txVector the TXVECTOR
+ * @param failures receives a line per field decoded differently
+ */
+void
+CheckRadiotapRoundTrip(const WifiTxVector& txVector, std::vector<std::string>& failures)
+{
+    uint8_t buffer[WifiCaptureWriter::MAX_RADIOTAP_SIZE];
+    MpduInfo aMpdu{NORMAL_MPDU, 0};
+    SignalNoiseDbm signalNoise{-60, -95};
+    std::size_t size =
+        WifiCaptureWriter::BuildRadiotap(buffer, 5180, txVector, aMpdu, &signalNoise, SU_STA_ID);
+    std::ostringstream name;
+    name << txVector.GetMode().GetUniqueName() << ", " << txVector.GetChannelWidth() << " MHz, "
+         << txVector.GetGuardInterval().GetNanoSeconds() << " ns, " << +txVector.GetNss()
+         << " streams: ";
+
+    RadiotapInfo info;
+    if (!ParseRadiotap(buffer, size, info))
+    {
+        failures.push_back(name.str() + "header not decoded");
+        return;
+    }
+    auto expect = [&](const std::string& field, uint32_t decoded, uint32_t written) {
+        if (decoded != written)
+        {
+            std::ostringstream failure;
+            failure << name.str() << field << " " << decoded << " instead of " << written;
+            failures.push_back(failure.str());
+        }
+    };
+    expect("length", info.length, size);
+    expect("MCS", info.mcs, txVector.GetMode().GetMcsValue());
+    expect("bandwidth", info.bandwidth, static_cast<uint32_t>(txVector.GetChannelWidth()));
+    expect("guard interval", info.guardInterval, txVector.GetGuardInterval().GetNanoSeconds());
+    expect("streams", info.nss, txVector.GetNss());
+}
+
+/**
+ * The VHT and HE fields written by WifiCaptureWriter decode to their TXVECTOR.
+ *
+ * @return the failures
+ */
+std::vector<std::string>
+CheckCaptureRadiotap()
+{
+    std::vector<std::string> failures;
+    for (uint16_t width : {20, 40, 80, 160})
+    {
+        for (uint8_t nss = 1; nss <= 4; ++nss)
+        {
+            for (uint8_t mcs = 0; mcs <= 11; ++mcs)
+            {
+                for (uint16_t guardInterval : {800, 1600, 3200})
+                {
+                    WifiTxVector txVector;
+                    txVector.SetMode(HePhy::GetHeMcs(mcs));
+                    txVector.SetPreambleType(WIFI_PREAMBLE_HE_SU);
+                    txVector.SetChannelWidth(MHz_u{static_cast<double>(width)});
+                    txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                    txVector.SetNss(nss);
+                    txVector.SetNTx(nss);
+                    CheckRadiotapRoundTrip(txVector, failures);
+                }
+                for (uint16_t guardInterval : {400, 800})
+                {
+                    if (mcs > 9)
+                    {
+                        continue;
+                    }
+                    WifiTxVector txVector;
+                    txVector.SetMode(VhtPhy::GetVhtMcs(mcs));
+                    txVector.SetPreambleType(WIFI_PREAMBLE_VHT_SU);
+                    txVector.SetChannelWidth(MHz_u{static_cast<double>(width)});
+                    txVector.SetGuardInterval(NanoSeconds(guardInterval));
+                    txVector.SetNss(nss);
+                    txVector.SetNTx(nss);
+                    CheckRadiotapRoundTrip(txVector, failures);
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * No layout places a station on the AP, at the origin.
+ *
+ * @return the failures
+ */
+std::vector<std::string>
+CheckStationLayout()
+{
+    std::vector<std::string> failures;
+    const double distance = 10;
+    for (const std::string topology : {"ring", "line", "grid"})
+    {
+        for (uint32_t nStations = 1; nStations <= 500; ++nStations)
+        {
+            Ptr<PositionAllocator> layout = CreateStationLayout(topology, nStations, distance);
+            for (uint32_t i = 0; i < nStations; ++i)
+            {
+                Vector position = layout->GetNext();
+                if (CalculateDistance(position, Vector(0, 0, 0)) < 1e-6 * distance)
+                {
+                    std::ostringstream failure;
+                    failure << topology << " of " << nStations << " stations: station " << i
+                            << " at the AP";
+                    failures.push_back(failure.str());
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+/// A named check
+struct Check
+{
+    std::string name;                  //!< Name of the check
+    std::vector<std::string> (*run)(); //!< Check, returning its failures
+};
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    const std::vector<Check> checks{
+        {"capture-radiotap", &CheckCaptureRadiotap},
+        {"station-layout", &CheckStationLayout},
+    };
+
+    int status = 0;
+    for (const auto& check : checks)
+    {
+        std::vector<std::string> failures = check.run();
+        std::cout << (failures.empty() ? "PASS " : "FAIL ") << check.name << "\n";
+        for (const auto& failure : failures)
+        {
+            std::cout << "    " << failure << "\n";
+        }
+        if (!failures.empty())
+        {
+            status = 1;
+        }
+    }
+    return status;
+}
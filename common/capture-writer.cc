@@ -0,0 +1,484 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "capture-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace ns3
+{
+
+namespace
+{
+
+constexpr uint32_t DLT_IEEE802_11_RADIO = 127; //!< Radiotap link-layer header type
+constexpr std::size_t RECORD_HEADER_SIZE = 16; //!< Size of a pcap record header
+constexpr uint32_t MAX_RECORD_SIZE = 65535;    //!< Snap length of whole-frame captures
+constexpr std::size_t MIN_CHUNK_SIZE = 65536;  //!< First allocation of a chunk
+
+/**
+ * Builds a radiotap header in a caller-provided buffer. Fields must be added
+ * in increasing bit order.
+ */
+class RadiotapBuilder
+{
+  public:
+    /**
+     * @param buffer a buffer of at least WifiCaptureWriter::MAX_RADIOTAP_SIZE bytes
+     */
+    explicit RadiotapBuilder(uint8_t* buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    /**
+     * Start a field.
+     *
+     * @param bit the bit of the field in the present word
+     * @param align the alignment of the field
+     */
+    void Field(uint32_t bit, std::size_t align)
+    {
+        m_present |= 1U << bit;
+        while (m_size % align)
+        {
+            m_buffer[m_size++] = 0;
+        }
+    }
+
+    /**
+     * @param value the next byte of the current field
+     */
+    void Put8(uint8_t value)
+    {
+        m_buffer[m_size++] = value;
+    }
+
+    /**
+     * @param value the next 16 bits of the current field
+     */
+    void Put16(uint16_t value)
+    {
+        Put8(value & 0xff);
+        Put8(value >> 8);
+    }
+
+    /**
+     * @param value the next 32 bits of the current field
+     */
+    void Put32(uint32_t value)
+    {
+        Put16(value & 0xffff);
+        Put16(value >> 16);
+    }
+
+    /**
+     * @param value the next 64 bits of the current field
+     */
+    void Put64(uint64_t value)
+    {
+        Put32(value & 0xffffffff);
+        Put32(value >> 32);
+    }
+
+    /**
+     * Write the fixed part of the header.
+     *
+     * @return the size of the header
+     */
+    std::size_t Finish()
+    {
+        m_buffer[0] = 0; // version
+        m_buffer[1] = 0; // padding
+        m_buffer[2] = m_size & 0xff;
+        m_buffer[3] = m_size >> 8;
+        for (int i = 0; i < 4; ++i)
+        {
+            m_buffer[4 + i] = (m_present >> (8 * i)) & 0xff;
+        }
+        return m_size;
+    }
+
+  private:
+    uint8_t* m_buffer;     //!< Header bytes
+    std::size_t m_size{8}; //!< Bytes written, fixed part included
+    uint32_t m_present{0}; //!< Present word
+};
+
+/**
+ * @param value a power in dBm
+ * @return the power as a radiotap dBm field
+ */
+uint8_t
+ToDbmField(double value)
+{
+    auto dbm = static_cast<int8_t>(std::clamp(std::round(value), -128.0, 127.0));
+    return static_cast<uint8_t>(dbm);
+}
+
+} // namespace
+
+std::size_t
+WifiCaptureWriter::BuildRadiotap(uint8_t* buffer,
+                                 uint16_t channelFreqMhz,
+                                 const WifiTxVector& txVector,
+                                 MpduInfo aMpdu,
+                                 const SignalNoiseDbm* signalNoise,
+                                 uint16_t staId)
+{
+    RadiotapBuilder radiotap(buffer);
+    WifiModulationClass modulation = txVector.GetModulationClass();
+    WifiMode mode = txVector.GetMode(staId);
+    auto width = static_cast<uint32_t>(txVector.GetChannelWidth());
+    bool shortGuardInterval = txVector.GetGuardInterval().GetNanoSeconds() == 400;
+    bool legacy = modulation == WIFI_MOD_CLASS_DSSS || modulation == WIFI_MOD_CLASS_HR_DSSS ||
+                  modulation == WIFI_MOD_CLASS_ERP_OFDM || modulation == WIFI_MOD_CLASS_OFDM;
+
+    radiotap.Field(0, 8); // TSFT
+    radiotap.Put64(Simulator::Now().GetMicroSeconds());
+    radiotap.Field(1, 1); // flags: the MPDU ends with its FCS
+    radiotap.Put8(0x10);
+    if (legacy)
+    {
+        radiotap.Field(2, 1); // rate, in 500 kbit/s
+        radiotap.Put8(mode.GetDataRate(txVector, staId) / 500000);
+    }
+    radiotap.Field(3, 2); // channel
+    radiotap.Put16(channelFreqMhz);
+    uint16_t channelFlags = channelFreqMhz < 3000 ? 0x0080 : 0x0100;
+    bool dsss = modulation == WIFI_MOD_CLASS_DSSS || modulation == WIFI_MOD_CLASS_HR_DSSS;
+    channelFlags |= dsss ? 0x0020 : 0x0040;
+    radiotap.Put16(channelFlags);
+    if (signalNoise)
+    {
+        radiotap.Field(5, 1);
+        radiotap.Put8(ToDbmField(signalNoise->signal));
+        radiotap.Field(6, 1);
+        radiotap.Put8(ToDbmField(signalNoise->noise));
+    }
+    if (modulation == WIFI_MOD_CLASS_HT)
+    {
+        radiotap.Field(19, 1); // MCS: bandwidth, MCS index and guard interval known
+        radiotap.Put8(0x07);
+        radiotap.Put8((width == 40 ? 0x01 : 0x00) | (shortGuardInterval ? 0x04 : 0x00));
+        radiotap.Put8(mode.GetMcsValue());
+    }
+    if (aMpdu.type != NORMAL_MPDU)
+    {
+        radiotap.Field(20, 4); // A-MPDU status: reference, last subframe known/last
+        radiotap.Put32(aMpdu.mpduRefNumber);
+        radiotap.Put16(aMpdu.type == LAST_MPDU_IN_AGGREGATE || aMpdu.type == SINGLE_MPDU
+                           ? 0x000c
+                           : 0x0004);
+        radiotap.Put8(0);
+        radiotap.Put8(0);
+    }
+    if (modulation == WIFI_MOD_CLASS_VHT)
+    {
+        radiotap.Field(21, 2); // VHT: guard interval and bandwidth known
+        radiotap.Put16(0x0044);
+        radiotap.Put8(shortGuardInterval ? 0x04 : 0x00);
+        radiotap.Put8(width >= 160 ? 11 : width >= 80 ? 4 : width >= 40 ? 1 : 0);
+        radiotap.Put8((mode.GetMcsValue() << 4) | txVector.GetNss(staId));
+        radiotap.Put8(0);
+        radiotap.Put8(0);
+        radiotap.Put8(0);
+        radiotap.Put8(0); // coding
+        radiotap.Put8(0); // group ID
+        radiotap.Put16(0); // partial AID
+    }
+    else if (modulation == WIFI_MOD_CLASS_HE || modulation == WIFI_MOD_CLASS_EHT)
+    {
+        // EHT PPDUs are described with the HE field as well
+        uint16_t guardInterval = txVector.GetGuardInterval().GetNanoSeconds();
+        radiotap.Field(23, 2); // HE: data1 to data6
+        radiotap.Put16(0x4020); // data MCS and bandwidth known
+        radiotap.Put16(0x0002); // guard interval known
+        radiotap.Put16(mode.GetMcsValue() << 8);
+        radiotap.Put16(0);
+        radiotap.Put16((width >= 160 ? 3 : width >= 80 ? 2 : width >= 40 ? 1 : 0) |
+                       ((guardInterval >= 3200 ? 2 : guardInterval >= 1600 ? 1 : 0) << 4));
+        radiotap.Put16(txVector.GetNss(staId));
+    }
+    return radiotap.Finish();
+}
+
+WifiCaptureWriter::WifiCaptureWriter(const Config& config)
+    : m_config(config)
+{
+    NS_ABORT_MSG_IF(m_config.sampling == 0, "The capture sampling must be at least 1");
+    NS_ABORT_MSG_IF(m_config.snapLength != 0 && m_config.snapLength < MAX_RADIOTAP_SIZE,
+                    "The capture snap length must be 0 or at least " << MAX_RADIOTAP_SIZE);
+    std::size_t largestRecord = RECORD_HEADER_SIZE + MAX_RADIOTAP_SIZE + MAX_RECORD_SIZE;
+    NS_ABORT_MSG_IF(m_config.chunkSize < largestRecord,
+                    "The capture chunks must hold at least one whole frame");
+}
+
+WifiCaptureWriter::~WifiCaptureWriter()
+{
+    Close();
+}
+
+void
+WifiCaptureWriter::Capture(const std::string& prefix, const NetDeviceContainer& devices)
+{
+    NS_ABORT_MSG_IF(m_closed, "The capture writer is closed");
+    NS_ABORT_MSG_IF(m_writer.joinable(), "Devices must be captured before the first frame");
+    for (auto it = devices.Begin(); it != devices.End(); ++it)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(*it);
+        NS_ABORT_MSG_IF(!device, "Only Wi-Fi devices can be captured");
+
+        std::ostringstream filename;
+        filename << prefix << "-" << device->GetNode()->GetId() << "-" << device->GetIfIndex()
+                 << ".pcap";
+        File file;
+        file.stream = std::fopen(filename.str().c_str(), "wb");
+        NS_ABORT_MSG_IF(!file.stream,
+                        "Cannot open " << filename.str() << ": " << std::strerror(errno));
+        // Whole chunks are written at once
+        std::setvbuf(file.stream, nullptr, _IONBF, 0);
+        uint32_t header[6] = {0xa1b2c3d4,
+                              2 | (4 << 16), // version 2.4
+                              0,
+                              0,
+                              m_config.snapLength ? m_config.snapLength : MAX_RECORD_SIZE,
+                              DLT_IEEE802_11_RADIO};
+        std::fwrite(header, 1, sizeof(header), file.stream);
+
+        auto index = static_cast<uint32_t>(m_files.size());
+        m_files.push_back(file);
+        Ptr<WifiPhy> phy = device->GetPhy();
+        phy->TraceConnectWithoutContext(
+            "MonitorSnifferRx",
+            MakeBoundCallback(&WifiCaptureWriter::SniffRx, this, index));
+        phy->TraceConnectWithoutContext(
+            "MonitorSnifferTx",
+            MakeBoundCallback(&WifiCaptureWriter::SniffTx, this, index));
+    }
+}
+
+void
+WifiCaptureWriter::SniffRx(WifiCaptureWriter* writer,
+                           uint32_t file,
+                           Ptr<const Packet> packet,
+                           uint16_t channelFreqMhz,
+                           WifiTxVector txVector,
+                           MpduInfo aMpdu,
+                           SignalNoiseDbm signalNoise,
+                           uint16_t staId)
+{
+    writer->Record(file, packet, channelFreqMhz, txVector, aMpdu, &signalNoise, staId);
+}
+
+void
+WifiCaptureWriter::SniffTx(WifiCaptureWriter* writer,
+                           uint32_t file,
+                           Ptr<const Packet> packet,
+                           uint16_t channelFreqMhz,
+                           WifiTxVector txVector,
+                           MpduInfo aMpdu,
+                           uint16_t staId)
+{
+    writer->Record(file, packet, channelFreqMhz, txVector, aMpdu, nullptr, staId);
+}
+
+void
+WifiCaptureWriter::Record(uint32_t file,
+                          Ptr<const Packet> packet,
+                          uint16_t channelFreqMhz,
+                          const WifiTxVector& txVector,
+                          MpduInfo aMpdu,
+                          const SignalNoiseDbm* signalNoise,
+                          uint16_t staId)
+{
+    File& f = m_files[file];
+    if (f.frames++ % m_config.sampling != 0)
+    {
+        ++m_skipped;
+        return;
+    }
+
+    uint8_t radiotap[MAX_RADIOTAP_SIZE];
+    std::size_t radiotapSize =
+        BuildRadiotap(radiotap, channelFreqMhz, txVector, aMpdu, signalNoise, staId);
+    uint32_t length = radiotapSize + packet->GetSize();
+    uint32_t captured = m_config.snapLength ? std::min(length, m_config.snapLength) : length;
+    std::size_t size = RECORD_HEADER_SIZE + captured;
+    if (f.chunk && f.chunk->used + size > m_config.chunkSize)
+    {
+        Submit(file);
+    }
+    if (!f.chunk)
+    {
+        f.chunk = TakeChunk();
+        f.chunk->stream = f.stream;
+    }
+    if (f.chunk->used + size > f.chunk->data.size())
+    {
+        // Chunks grow with their file, so quiet devices hold little memory
+        f.chunk->data.resize(std::min(
+            m_config.chunkSize,
+            std::max({2 * f.chunk->data.size(), f.chunk->used + size, MIN_CHUNK_SIZE})));
+    }
+
+    uint8_t* record = f.chunk->data.data() + f.chunk->used;
+    int64_t now = Simulator::Now().GetMicroSeconds();
+    uint32_t header[4] = {static_cast<uint32_t>(now / 1000000),
+                          static_cast<uint32_t>(now % 1000000),
+                          captured,
+                          length};
+    std::memcpy(record, header, sizeof(header));
+    std::memcpy(record + RECORD_HEADER_SIZE, radiotap, radiotapSize);
+    if (captured > radiotapSize)
+    {
+        packet->CopyData(record + RECORD_HEADER_SIZE + radiotapSize, captured - radiotapSize);
+    }
+    f.chunk->used += size;
+    ++m_records;
+}
+
+WifiCaptureWriter::Chunk*
+WifiCaptureWriter::TakeChunk()
+{
+    Chunk* chunk = nullptr;
+    if (!m_free || !m_free->TryPop(chunk))
+    {
+        // Grow the pool up to its limit before waiting for the writer
+        if (!m_free || m_chunks.size() < m_files.size() + m_config.spareChunks)
+        {
+            m_chunks.push_back(std::make_unique<Chunk>());
+            chunk = m_chunks.back().get();
+        }
+        else
+        {
+            chunk = m_free->Pop();
+        }
+    }
+    chunk->used = 0;
+    return chunk;
+}
+
+void
+WifiCaptureWriter::Submit(uint32_t file)
+{
+    File& f = m_files[file];
+    if (!m_config.background)
+    {
+        std::fwrite(f.chunk->data.data(), 1, f.chunk->used, f.stream);
+        f.chunk->used = 0;
+        return;
+    }
+
+    if (!m_writer.joinable())
+    {
+        StartWriter();
+    }
+    m_filled->Push(f.chunk);
+    f.chunk = nullptr;
+}
+
+void
+WifiCaptureWriter::StartWriter()
+{
+    // Every chunk of the pool, and the null chunk stopping the writer, fits in the queues
+    std::size_t capacity = m_files.size() + m_config.spareChunks + 1;
+    m_filled = std::make_unique<SpscQueue<Chunk*>>(capacity);
+    m_free = std::make_unique<SpscQueue<Chunk*>>(capacity);
+    m_writer = std::thread(&WifiCaptureWriter::WriterLoop, this);
+}
+
+void
+WifiCaptureWriter::WriterLoop()
+{
+    while (Chunk* chunk = m_filled->Pop())
+    {
+        std::fwrite(chunk->data.data(), 1, chunk->used, chunk->stream);
+        m_free->Push(chunk);
+    }
+}
+
+void
+WifiCaptureWriter::Close()
+{
+    if (m_closed)
+    {
+        return;
+    }
+    m_closed = true;
+    for (uint32_t file = 0; file < m_files.size(); ++file)
+    {
+        if (m_files[file].chunk && m_files[file].chunk->used > 0)
+        {
+            Submit(file);
+        }
+    }
+    if (m_writer.joinable())
+    {
+        m_filled->Push(nullptr);
+        m_writer.join();
+    }
+    for (auto& file : m_files)
+    {
+        std::fclose(file.stream);
+    }
+}
+
+uint64_t
+WifiCaptureWriter::GetNRecords() const
+{
+    return m_records;
+}
+
+uint64_t
+WifiCaptureWriter::GetNSkipped() const
+{
+    return m_skipped;
+}
+
+CaptureStationFilter::CaptureStationFilter(const std::string& filter)
+{
+    std::istringstream list(filter);
+    for (std::string item; std::getline(list, item, ',');)
+    {
+        if (item == "all")
+        {
+            m_all = true;
+        }
+        else if (item == "ap")
+        {
+            m_ap = true;
+        }
+        else
+        {
+            NS_ABORT_MSG_IF(item.empty() ||
+                                item.find_first_not_of("0123456789") != std::string::npos,
+                            "Invalid capture station '" << item << "', use all, ap or an index");
+            m_stations.insert(std::stoul(item));
+        }
+    }
+}
+
+bool
+CaptureStationFilter::IncludesAp() const
+{
+    return m_all || m_ap;
+}
+
+bool
+CaptureStationFilter::IncludesStation(uint32_t station) const
+{
+    return m_all || m_stations.count(station);
+}
+
+} // namespace ns3
@@ -0,0 +1,264 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_CAPTURE_WRITER_H
+#define SCRATCH_CAPTURE_WRITER_H
+
+// Low-overhead radiotap pcap capture of Wi-Fi devices.
+
+#include "spsc-queue.h"
+
+#include "ns3/net-device-container.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/wifi-phy.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Writes radiotap pcap files from the monitor sniffer traces of Wi-Fi PHYs,
+ * as WifiPhyHelper::EnablePcap() does, but with a smaller cost per frame:
+ *
+ *  - the radiotap header is built in place instead of being serialized from
+ *    a copy of the packet;
+ *  - only the first snapLength bytes of each record are copied and written
+ *    (e.g. 128 keeps the radiotap and MAC headers);
+ *  - only one frame out of every sampling frames of a device is written;
+ *  - records are appended to per-file chunks, which grow with the records of
+ *    their file up to chunkSize and are then written either directly or,
+ *    with background writing, by a writer thread fed through a lock-free
+ *    queue, so the simulation thread never waits for the disk unless the
+ *    writer falls behind by every spare chunk. The writer thread and its
+ *    queues are created with the first full chunk, sized for the files
+ *    captured by then, so any number of devices can be captured.
+ *
+ * The records hold the radiotap fields read by pcap-analyzer and Wireshark:
+ * TSFT, flags, rate or MCS/VHT/HE, channel, A-MPDU status, and antenna
+ * signal and noise for received frames.
+ */
+class WifiCaptureWriter
+{
+  public:
+    /// Upper bound of the size of the radiotap headers written
+    static constexpr std::size_t MAX_RADIOTAP_SIZE = 64;
+
+    /// Capture settings
+    struct Config
+    {
+        uint32_t snapLength{0};                 //!< Bytes kept per record, 0 for whole frames
+        uint32_t sampling{1};                   //!< Write one frame out of this many per device
+        bool background{true};                  //!< Write the chunks from a separate thread
+        std::size_t chunkSize{4 * 1024 * 1024}; //!< Largest size of a write chunk in bytes
+        uint32_t spareChunks{8};                //!< Chunks in flight beyond one per file
+    };
+
+    /**
+     * @param config the capture settings
+     */
+    explicit WifiCaptureWriter(const Config& config);
+
+    /**
+     * Closes the capture files.
+     */
+    ~WifiCaptureWriter();
+
+    WifiCaptureWriter(const WifiCaptureWriter&) = delete;
+    WifiCaptureWriter& operator=(const WifiCaptureWriter&) = delete;
+
+    /**
+     * Capture the frames sent and received by Wi-Fi devices, in one file per
+     * device named like those of WifiPhyHelper::EnablePcap():
+     * <prefix>-<node id>-<device id>.pcap. Every device must be captured
+     * before the simulation starts.
+     *
+     * @param prefix the file name prefix
+     * @param devices the Wi-Fi devices
+     */
+    void Capture(const std::string& prefix, const NetDeviceContainer& devices);
+
+    /**
+     * Write the pending records and close the files. Call it after
+     * Simulator::Run().
+     */
+    void Close();
+
+    /**
+     * @return the number of records written
+     */
+    uint64_t GetNRecords() const;
+
+    /**
+     * @return the number of frames skipped by sampling
+     */
+    uint64_t GetNSkipped() const;
+
+    /**
+     * Build the radiotap header written before an MPDU.
+     *
+     * @param buffer receives the header, at least MAX_RADIOTAP_SIZE bytes
+     * @param channelFreqMhz the channel center frequency
+     * @param txVector the TXVECTOR of the PPDU
+     * @param aMpdu the position of the MPDU in its A-MPDU
+     * @param signalNoise the signal and noise power, or nullptr for a transmitted frame
+     * @param staId the station ID of the PSDU
+     * @return the size of the header
+     */
+    static std::size_t BuildRadiotap(uint8_t* buffer,
+                                     uint16_t channelFreqMhz,
+                                     const WifiTxVector& txVector,
+                                     MpduInfo aMpdu,
+                                     const SignalNoiseDbm* signalNoise,
+                                     uint16_t staId);
+
+  private:
+    /// A block of consecutive records of one file
+    struct Chunk
+    {
+        std::vector<uint8_t> data;  //!< Record bytes, grown up to the chunk size
+        std::size_t used{0};        //!< Bytes of data in use
+        std::FILE* stream{nullptr}; //!< Destination file
+    };
+
+    /// A capture file
+    struct File
+    {
+        std::FILE* stream{nullptr}; //!< Output stream
+        Chunk* chunk{nullptr};      //!< Chunk being filled, null until a record needs one
+        uint64_t frames{0};         //!< Frames seen, for sampling
+    };
+
+    /**
+     * Trace sink for WifiPhy::MonitorSnifferRx.
+     *
+     * @param writer the capture writer
+     * @param file the index of the capture file
+     * @param packet the received MPDU
+     * @param channelFreqMhz the channel center frequency
+     * @param txVector the TXVECTOR of the PPDU
+     * @param aMpdu the position of the MPDU in its A-MPDU
+     * @param signalNoise the signal and noise power
+     * @param staId the station ID of the PSDU
+     */
+    static void SniffRx(WifiCaptureWriter* writer,
+                        uint32_t file,
+                        Ptr<const Packet> packet,
+                        uint16_t channelFreqMhz,
+                        WifiTxVector txVector,
+                        MpduInfo aMpdu,
+                        SignalNoiseDbm signalNoise,
+                        uint16_t staId);
+
+    /**
+     * Trace sink for WifiPhy::MonitorSnifferTx.
+     *
+     * @param writer the capture writer
+     * @param file the index of the capture file
+     * @param packet the transmitted MPDU
+     * @param channelFreqMhz the channel center frequency
+     * @param txVector the TXVECTOR of the PPDU
+     * @param aMpdu the position of the MPDU in its A-MPDU
+     * @param staId the station ID of the PSDU
+     */
+    static void SniffTx(WifiCaptureWriter* writer,
+                        uint32_t file,
+                        Ptr<const Packet> packet,
+                        uint16_t channelFreqMhz,
+                        WifiTxVector txVector,
+                        MpduInfo aMpdu,
+                        uint16_t staId);
+
+    /**
+     * Append a record to the chunk of a file.
+     *
+     * @param file the index of the capture file
+     * @param packet the MPDU
+     * @param channelFreqMhz the channel center frequency
+     * @param txVector the TXVECTOR of the PPDU
+     * @param aMpdu the position of the MPDU in its A-MPDU
+     * @param signalNoise the signal and noise power, or nullptr for a transmitted frame
+     * @param staId the station ID of the PSDU
+     */
+    void Record(uint32_t file,
+                Ptr<const Packet> packet,
+                uint16_t channelFreqMhz,
+                const WifiTxVector& txVector,
+                MpduInfo aMpdu,
+                const SignalNoiseDbm* signalNoise,
+                uint16_t staId);
+
+    /**
+     * Hand the chunk of a file over for writing.
+     *
+     * @param file the index of the capture file
+     */
+    void Submit(uint32_t file);
+
+    /**
+     * @return an empty chunk, written already or new while the pool has room
+     */
+    Chunk* TakeChunk();
+
+    /**
+     * Create the queues, sized for the pool of chunks, and the writer thread.
+     */
+    void StartWriter();
+
+    /**
+     * Body of the writer thread: write the submitted chunks until a null
+     * chunk is received.
+     */
+    void WriterLoop();
+
+    Config m_config;                              //!< Capture settings
+    std::vector<File> m_files;                    //!< Capture files
+    std::vector<std::unique_ptr<Chunk>> m_chunks; //!< Every allocated chunk
+    std::unique_ptr<SpscQueue<Chunk*>> m_filled;  //!< Chunks to write, to the writer thread
+    std::unique_ptr<SpscQueue<Chunk*>> m_free;    //!< Written chunks, from the writer thread
+    std::thread m_writer;                         //!< Writer thread
+    uint64_t m_records{0};                        //!< Records written
+    uint64_t m_skipped{0};                        //!< Frames skipped by sampling
+    bool m_closed{false};                         //!< Whether Close() was called
+};
+
+/**
+ * Selects the devices to capture from a list such as "all", "ap" or
+ * "ap,0,2", where numbers are station indices.
+ */
+class CaptureStationFilter
+{
+  public:
+    /**
+     * @param filter "all", or a comma separated list of "ap" and station indices
+     */
+    explicit CaptureStationFilter(const std::string& filter);
+
+    /**
+     * @return whether the access point is captured
+     */
+    bool IncludesAp() const;
+
+    /**
+     * @param station the index of a station
+     * @return whether the station is captured
+     */
+    bool IncludesStation(uint32_t station) const;
+
+  private:
+    bool m_all{false};             //!< Whether every device is captured
+    bool m_ap{false};              //!< Whether the access point is captured
+    std::set<uint32_t> m_stations; //!< Captured station indices
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_CAPTURE_WRITER_H */
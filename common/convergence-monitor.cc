@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "convergence-monitor.h"
+
+#include "throughput-sampler.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ConvergenceMonitor");
+
+ConvergenceMonitor::ConvergenceMonitor(const Config& config)
+    : m_config(config)
+{
+    NS_ABORT_MSG_IF(config.relativeHalfWidth <= 0, "The target half width must be positive");
+    NS_ABORT_MSG_IF(config.minBatches < 2, "At least two batches are needed");
+}
+
+void
+ConvergenceMonitor::Attach(ThroughputSampler& sampler)
+{
+    m_bucketsPerBatch = std::max<int64_t>(
+        1,
+        std::llround(m_config.batch.GetSeconds() / sampler.GetBucketWidth().GetSeconds()));
+    sampler.SetBucketCallback(
+        [this, next = sampler.GetBucketCallback()](const ThroughputSampler& s, uint64_t bucket) {
+            if (next)
+            {
+                next(s, bucket);
+            }
+            AddBucket(s, bucket);
+        });
+}
+
+bool
+ConvergenceMonitor::HasConverged() const
+{
+    return m_converged;
+}
+
+Time
+ConvergenceMonitor::GetStopTime() const
+{
+    return m_stopTime;
+}
+
+uint32_t
+ConvergenceMonitor::GetNBatches() const
+{
+    return m_means.empty() ? 0 : m_means[0].size();
+}
+
+SampleSummary
+ConvergenceMonitor::GetSummary(uint32_t flow) const
+{
+    if (flow >= m_means.size())
+    {
+        return {};
+    }
+    return Summarize(m_means[flow], m_config.confidence);
+}
+
+void
+ConvergenceMonitor::Print(std::ostream& os) const
+{
+    if (m_converged)
+    {
+        os << "Throughput converged after " << GetNBatches() << " batches, stopped at "
+           << m_stopTime.GetSeconds() << " s" << std::endl;
+    }
+    else
+    {
+        os << "Throughput did not converge (" << GetNBatches() << " batches after the warm-up)"
+           << std::endl;
+    }
+}
+
+void
+ConvergenceMonitor::AddBucket(const ThroughputSampler& sampler, uint64_t bucket)
+{
+    if (m_converged ||
+        sampler.GetBucketStart(bucket) - sampler.GetBucketStart(0) < m_config.warmup)
+    {
+        return;
+    }
+
+    // Flows from unregistered sources appear while the simulation runs
+    uint32_t flows = sampler.GetNFlows();
+    if (m_batchBytes.size() < flows)
+    {
+        m_batchBytes.resize(flows, 0);
+        m_means.resize(flows, std::vector<double>(GetNBatches(), 0.0));
+    }
+    for (uint32_t flow = 0; flow < flows; ++flow)
+    {
+        m_batchBytes[flow] += sampler.GetBytes(flow, bucket);
+    }
+    if (++m_bucketsInBatch < m_bucketsPerBatch)
+    {
+        return;
+    }
+
+    double seconds = m_bucketsPerBatch * sampler.GetBucketWidth().GetSeconds();
+    for (uint32_t flow = 0; flow < flows; ++flow)
+    {
+        m_means[flow].push_back(m_batchBytes[flow] * 8 / (1e6 * seconds));
+        m_batchBytes[flow] = 0;
+    }
+    m_bucketsInBatch = 0;
+    if (GetNBatches() < m_config.minBatches)
+    {
+        return;
+    }
+
+    for (uint32_t flow = 0; flow < flows; ++flow)
+    {
+        SampleSummary summary = GetSummary(flow);
+        if (summary.halfWidth > m_config.relativeHalfWidth * std::abs(summary.mean))
+        {
+            return;
+        }
+    }
+    m_converged = true;
+    m_stopTime = Simulator::Now();
+    NS_LOG_INFO("Converged after " << GetNBatches() << " batches at " << m_stopTime.As(Time::S));
+    Simulator::Stop();
+}
+
+} // namespace ns3
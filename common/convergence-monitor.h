@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_CONVERGENCE_MONITOR_H
+#define SCRATCH_CONVERGENCE_MONITOR_H
+
+// Batch-means stopping rule for throughput runs.
+
+#include "statistics.h"
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace ns3
+{
+
+class ThroughputSampler;
+
+/**
+ * Stops the simulation once the per-flow throughput of a ThroughputSampler
+ * has converged.
+ *
+ * The buckets of the sampler that start within the warm-up are discarded;
+ * the following ones are grouped into consecutive batches and the mean
+ * throughput of each flow in each batch is a sample. After every batch, once
+ * there are at least minBatches of them, the Student t confidence interval
+ * of the mean of the batch means is computed for every flow, and
+ * Simulator::Stop() is called when its half width is below
+ * relativeHalfWidth times the mean for every flow. The stop time set by the
+ * scenario remains the maximum.
+ *
+ * Flows whose throughput is close to zero rarely meet a relative target and
+ * keep the simulation running until the maximum time.
+ */
+class ConvergenceMonitor
+{
+  public:
+    /// Stopping rule settings
+    struct Config
+    {
+        Time warmup{Seconds(1)};        //!< Sampled time discarded at the start
+        Time batch{MilliSeconds(500)};  //!< Length of a batch, a multiple of the bucket width
+        double relativeHalfWidth{0.05}; //!< Target half width relative to the mean
+        double confidence{0.95};        //!< Confidence level of the intervals
+        uint32_t minBatches{10};        //!< Batches needed before stopping
+    };
+
+    /**
+     * @param config the stopping rule settings
+     */
+    explicit ConvergenceMonitor(const Config& config);
+
+    /**
+     * Follow the completed buckets of a sampler, after the bucket callback
+     * already set on it. The monitor must outlive the simulation.
+     *
+     * @param sampler the throughput sampler, with every flow added
+     */
+    void Attach(ThroughputSampler& sampler);
+
+    /**
+     * @return whether the simulation was stopped by the rule
+     */
+    bool HasConverged() const;
+
+    /**
+     * @return the time at which the rule stopped the simulation
+     */
+    Time GetStopTime() const;
+
+    /**
+     * @return the number of complete batches
+     */
+    uint32_t GetNBatches() const;
+
+    /**
+     * @param flow the flow index
+     * @return the mean of the batch means of the flow in Mbit/s and its confidence interval
+     */
+    SampleSummary GetSummary(uint32_t flow) const;
+
+    /**
+     * Print whether and when the throughput converged, on one line.
+     *
+     * @param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /**
+     * Account for a completed bucket and apply the stopping rule.
+     *
+     * @param sampler the throughput sampler
+     * @param bucket the index of the bucket
+     */
+    void AddBucket(const ThroughputSampler& sampler, uint64_t bucket);
+
+    Config m_config;                          //!< Stopping rule settings
+    uint64_t m_bucketsPerBatch{1};            //!< Sampler buckets in a batch
+    uint64_t m_bucketsInBatch{0};             //!< Buckets added to the current batch
+    std::vector<uint64_t> m_batchBytes;       //!< Bytes of each flow in the current batch
+    std::vector<std::vector<double>> m_means; //!< Batch means of each flow in Mbit/s
+    bool m_converged{false};                  //!< Whether the rule stopped the simulation
+    Time m_stopTime;                          //!< Time of the stop
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_CONVERGENCE_MONITOR_H */
@@ -0,0 +1,167 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "distance-sweep.h"
+
+#include "throughput-sampler.h"
+
+#include "ns3/abort.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("DistanceSweep");
+
+DistanceSweep::DistanceSweep(const Config& config)
+    : m_config(config),
+      m_direction(config.end < config.start ? -1 : 1)
+{
+    NS_ABORT_MSG_IF(config.step <= 0, "The distance step must be positive");
+    NS_ABORT_MSG_IF(config.start < 0 || config.end < 0, "Distances cannot be negative");
+    NS_ABORT_MSG_IF(!config.dwell.IsStrictlyPositive(), "The dwell time must be positive");
+    NS_ABORT_MSG_IF(!config.continuous && config.settle >= config.dwell,
+                    "The settle time must be shorter than the dwell time");
+    m_nBands = static_cast<uint32_t>(std::floor(std::abs(config.end - config.start) / config.step +
+                                                1e-9)) +
+               1;
+    NS_ABORT_MSG_IF(config.continuous &&
+                        std::min(GetDistance(0), GetDistance(m_nBands - 1)) < config.step / 2,
+                    "The continuous path would pass the access point");
+    m_bytes.assign(m_nBands, 0);
+    m_sampled.assign(m_nBands, Time());
+}
+
+void
+DistanceSweep::ParseBands(const std::string& spec, Config& config)
+{
+    std::istringstream is(spec);
+    char first = 0;
+    char second = 0;
+    is >> config.start >> first >> config.end >> second >> config.step;
+    NS_ABORT_MSG_IF(is.fail() || first != ':' || second != ':' || !(is >> std::ws).eof(),
+                    "Invalid distance sweep '" << spec << "', expected start:end:step");
+}
+
+void
+DistanceSweep::Install(Ptr<ConstantVelocityMobilityModel> station, const Vector& origin) const
+{
+    NS_ABORT_MSG_UNLESS(station, "The station needs a ConstantVelocityMobilityModel");
+    Time now = Simulator::Now();
+    NS_ABORT_MSG_IF(m_config.begin < now, "The sweep begins in the past");
+    if (m_config.continuous)
+    {
+        double speed = m_direction * m_config.step / m_config.dwell.GetSeconds();
+        double first = GetDistance(0) - m_direction * m_config.step / 2;
+        station->SetPosition(origin + Vector(first, 0, 0));
+        Simulator::Schedule(m_config.begin - now,
+                            &ConstantVelocityMobilityModel::SetVelocity,
+                            station,
+                            Vector(speed, 0, 0));
+        Simulator::Schedule(GetEnd() - now,
+                            &ConstantVelocityMobilityModel::SetVelocity,
+                            station,
+                            Vector(0, 0, 0));
+        return;
+    }
+    station->SetPosition(origin + Vector(GetDistance(0), 0, 0));
+    for (uint32_t band = 1; band < m_nBands; ++band)
+    {
+        Simulator::Schedule(m_config.begin + m_config.dwell * band - now,
+                            &MobilityModel::SetPosition,
+                            station,
+                            origin + Vector(GetDistance(band), 0, 0));
+    }
+}
+
+void
+DistanceSweep::Attach(ThroughputSampler& sampler, uint32_t flow)
+{
+    m_flow = flow;
+    sampler.SetBucketCallback(
+        [this, next = sampler.GetBucketCallback()](const ThroughputSampler& s, uint64_t bucket) {
+            if (next)
+            {
+                next(s, bucket);
+            }
+            AddBucket(s, bucket);
+        });
+}
+
+uint32_t
+DistanceSweep::GetNBands() const
+{
+    return m_nBands;
+}
+
+double
+DistanceSweep::GetDistance(uint32_t band) const
+{
+    return m_config.start + m_direction * m_config.step * band;
+}
+
+double
+DistanceSweep::GetThroughput(uint32_t band) const
+{
+    if (band >= m_nBands || !m_sampled[band].IsStrictlyPositive())
+    {
+        return 0;
+    }
+    return m_bytes[band] * 8 / (1e6 * m_sampled[band].GetSeconds());
+}
+
+Time
+DistanceSweep::GetEnd() const
+{
+    return m_config.begin + m_config.dwell * m_nBands;
+}
+
+void
+DistanceSweep::Print(std::ostream& os) const
+{
+    os << "Throughput versus distance (" << (m_config.continuous ? "continuous" : "stepwise")
+       << " path, " << m_config.dwell.GetSeconds() << " s per band):" << std::endl;
+    for (uint32_t band = 0; band < m_nBands; ++band)
+    {
+        os << std::setw(8) << GetDistance(band) << " m: \t";
+        if (m_sampled[band].IsStrictlyPositive())
+        {
+            os << GetThroughput(band) << " Mbit/s" << std::endl;
+        }
+        else
+        {
+            os << "not sampled" << std::endl;
+        }
+    }
+}
+
+void
+DistanceSweep::AddBucket(const ThroughputSampler& sampler, uint64_t bucket)
+{
+    /* A bucket belongs to the band of its middle, so that the buckets need not be aligned with
+     * the bands */
+    Time width = sampler.GetBucketWidth();
+    Time offset = sampler.GetBucketStart(bucket) + width / 2 - m_config.begin;
+    if (offset.IsStrictlyNegative() || offset >= m_config.dwell * m_nBands)
+    {
+        return;
+    }
+    auto band = static_cast<uint32_t>(offset.GetTimeStep() / m_config.dwell.GetTimeStep());
+    if (!m_config.continuous && offset - m_config.dwell * band < m_config.settle)
+    {
+        return;
+    }
+    m_bytes[band] += sampler.GetBytes(m_flow, bucket);
+    m_sampled[band] += width;
+}
+
+} // namespace ns3
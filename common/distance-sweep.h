@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_DISTANCE_SWEEP_H
+#define SCRATCH_DISTANCE_SWEEP_H
+
+// Throughput versus distance from a single run, with a station moved along a scripted path.
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class ConstantVelocityMobilityModel;
+class ThroughputSampler;
+
+/**
+ * Moves a station away from (or towards) its access point along the x axis
+ * and bins the throughput of a ThroughputSampler flow per distance band,
+ * giving the throughput versus distance curve of one run.
+ *
+ * The station spends dwell in each band, from begin on. In stepwise mode it
+ * jumps to the distance of each band, and the first settle of every band is
+ * discarded while the rate and the TCP window adapt. In continuous mode it
+ * moves at step / dwell and a band collects the buckets during which the
+ * station is within step / 2 of its distance.
+ *
+ * Each jump fires the CourseChange trace, so the propagation cache stays
+ * valid in stepwise mode; in continuous mode the position changes without
+ * it, and the cache must not be enabled.
+ */
+class DistanceSweep
+{
+  public:
+    /// Path settings
+    struct Config
+    {
+        double start{5};                //!< Distance of the first band in meters
+        double end{165};                //!< Distance of the last band in meters
+        double step{10};                //!< Distance between consecutive bands in meters
+        bool continuous{false};         //!< Move at constant velocity rather than in steps
+        Time begin{Seconds(1)};         //!< Time at which the first band starts
+        Time dwell{Seconds(2)};         //!< Time spent in each band
+        Time settle{MilliSeconds(500)}; //!< Time discarded after each step
+    };
+
+    /**
+     * @param config the path settings
+     */
+    explicit DistanceSweep(const Config& config);
+
+    /**
+     * Parse the bands of a sweep.
+     *
+     * @param spec "start:end:step" in meters, e.g. "5:165:10"
+     * @param config the settings receiving the bands
+     */
+    static void ParseBands(const std::string& spec, Config& config);
+
+    /**
+     * Place the station at the start of the path and schedule its moves.
+     *
+     * @param station the mobility model of the station
+     * @param origin the position of the access point
+     */
+    void Install(Ptr<ConstantVelocityMobilityModel> station, const Vector& origin) const;
+
+    /**
+     * Follow the completed buckets of a sampler, after the bucket callback
+     * already set on it. The sweep must outlive the simulation.
+     *
+     * @param sampler the throughput sampler
+     * @param flow the index of the flow of the station
+     */
+    void Attach(ThroughputSampler& sampler, uint32_t flow = 0);
+
+    /**
+     * @return the number of distance bands
+     */
+    uint32_t GetNBands() const;
+
+    /**
+     * @param band the band index
+     * @return the distance of the band in meters
+     */
+    double GetDistance(uint32_t band) const;
+
+    /**
+     * @param band the band index
+     * @return the throughput measured in the band in Mbit/s, 0 if not measured
+     */
+    double GetThroughput(uint32_t band) const;
+
+    /**
+     * @return the time at which the last band ends
+     */
+    Time GetEnd() const;
+
+    /**
+     * Print the throughput of every band.
+     *
+     * @param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /**
+     * Add a completed bucket to the band it belongs to.
+     *
+     * @param sampler the throughput sampler
+     * @param bucket the index of the bucket
+     */
+    void AddBucket(const ThroughputSampler& sampler, uint64_t bucket);
+
+    Config m_config;               //!< Path settings
+    double m_direction;            //!< +1 when moving away from the access point, -1 otherwise
+    uint32_t m_nBands;             //!< Number of bands
+    uint32_t m_flow{0};            //!< Flow of the station in the sampler
+    std::vector<uint64_t> m_bytes; //!< Bytes received per band
+    std::vector<Time> m_sampled;   //!< Time sampled per band
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_DISTANCE_SWEEP_H */
@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "echo-load-client.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/seq-ts-header.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EchoLoadClient");
+
+NS_OBJECT_ENSURE_REGISTERED(EchoLoadClient);
+
+TypeId
+EchoLoadClient::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EchoLoadClient")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<EchoLoadClient>()
+            .AddAttribute("Remote",
+                          "Address and port of the echo server",
+                          AddressValue(),
+                          MakeAddressAccessor(&EchoLoadClient::m_peer),
+                          MakeAddressChecker())
+            .AddAttribute("PacketSize",
+                          "Size of the UDP payload, SeqTsHeader included",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&EchoLoadClient::m_size),
+                          MakeUintegerChecker<uint32_t>(12))
+            .AddAttribute("Interval",
+                          "Mean interval between packets",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&EchoLoadClient::m_interval),
+                          MakeTimeChecker(Time(1)))
+            .AddAttribute("Poisson",
+                          "Whether the intervals are exponential rather than constant",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&EchoLoadClient::m_poisson),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+EchoLoadClient::EchoLoadClient()
+    : m_gaps(CreateObject<ExponentialRandomVariable>())
+{
+}
+
+EchoLoadClient::~EchoLoadClient() = default;
+
+const LatencyHistogram&
+EchoLoadClient::GetLatencies() const
+{
+    return m_latencies;
+}
+
+uint64_t
+EchoLoadClient::GetNSent() const
+{
+    return m_sent;
+}
+
+uint64_t
+EchoLoadClient::GetNReceived() const
+{
+    return m_received;
+}
+
+uint64_t
+EchoLoadClient::GetRxBytes() const
+{
+    return m_rxBytes;
+}
+
+int64_t
+EchoLoadClient::AssignStreams(int64_t stream)
+{
+    m_gaps->SetStream(stream);
+    return 1;
+}
+
+void
+EchoLoadClient::DoDispose()
+{
+    m_socket = nullptr;
+    m_gaps = nullptr;
+    Application::DoDispose();
+}
+
+void
+EchoLoadClient::StartApplication()
+{
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        int bound = Inet6SocketAddress::IsMatchingType(m_peer) ? m_socket->Bind6()
+                                                               : m_socket->Bind();
+        NS_ABORT_MSG_IF(bound == -1 || m_socket->Connect(m_peer) == -1,
+                        "Cannot connect to the echo server");
+    }
+    m_socket->SetRecvCallback(MakeCallback(&EchoLoadClient::HandleRead, this));
+    m_gaps->SetAttribute("Mean", DoubleValue(m_interval.GetSeconds()));
+    Send();
+}
+
+void
+EchoLoadClient::StopApplication()
+{
+    m_sendEvent.Cancel();
+    if (m_socket)
+    {
+        m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+}
+
+void
+EchoLoadClient::ScheduleNext()
+{
+    Time gap = m_poisson ? Seconds(m_gaps->GetValue()) : m_interval;
+    m_sendEvent = Simulator::Schedule(gap, &EchoLoadClient::Send, this);
+}
+
+void
+EchoLoadClient::Send()
+{
+    SeqTsHeader header;
+    header.SetSeq(m_seq++);
+    Ptr<Packet> packet = Create<Packet>(m_size - header.GetSerializedSize());
+    packet->AddHeader(header);
+    if (m_socket->Send(packet) >= 0)
+    {
+        ++m_sent;
+    }
+    ScheduleNext();
+}
+
+void
+EchoLoadClient::HandleRead(Ptr<Socket> socket)
+{
+    Ptr<Packet> packet;
+    while ((packet = socket->Recv()))
+    {
+        uint32_t size = packet->GetSize();
+        SeqTsHeader header;
+        if (size < header.GetSerializedSize())
+        {
+            continue;
+        }
+        packet->RemoveHeader(header);
+        m_latencies.Add(Simulator::Now() - header.GetTs());
+        ++m_received;
+        m_rxBytes += size;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_ECHO_LOAD_CLIENT_H
+#define SCRATCH_ECHO_LOAD_CLIENT_H
+
+// UDP echo client sending at a fixed or Poisson rate and recording round trip times.
+
+#include "latency-histogram.h"
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+class Socket;
+
+/**
+ * Client of a UdpEchoServer generating load rather than a few echoes: it
+ * sends packets at a constant interval, or with exponential gaps of the
+ * same mean (a Poisson process), whatever the replies. Every packet starts
+ * with a SeqTsHeader, so that the round trip time of each echo is computed
+ * from the echo itself and recorded into a LatencyHistogram. Nothing is
+ * logged per packet.
+ */
+class EchoLoadClient : public Application
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    EchoLoadClient();
+    ~EchoLoadClient() override;
+
+    /**
+     * @return the round trip times of the echoes received
+     */
+    const LatencyHistogram& GetLatencies() const;
+
+    /**
+     * @return the number of packets sent
+     */
+    uint64_t GetNSent() const;
+
+    /**
+     * @return the number of echoes received
+     */
+    uint64_t GetNReceived() const;
+
+    /**
+     * @return the bytes of the echoes received (UDP payload)
+     */
+    uint64_t GetRxBytes() const;
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this application.
+     *
+     * @param stream first stream index to use
+     * @return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream) override;
+
+  private:
+    void DoDispose() override;
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /**
+     * Schedule the next packet.
+     */
+    void ScheduleNext();
+
+    /**
+     * Send a packet and schedule the next one.
+     */
+    void Send();
+
+    /**
+     * Record the echoes received.
+     *
+     * @param socket the socket
+     */
+    void HandleRead(Ptr<Socket> socket);
+
+    Address m_peer;                        //!< Address of the echo server
+    uint32_t m_size;                       //!< Packet size, SeqTsHeader included
+    Time m_interval;                       //!< Mean interval between packets
+    bool m_poisson;                        //!< Whether the gaps are exponential
+    Ptr<ExponentialRandomVariable> m_gaps; //!< Gaps of the Poisson schedule
+
+    Ptr<Socket> m_socket;         //!< Socket to the server
+    EventId m_sendEvent;          //!< Next packet
+    uint32_t m_seq{0};            //!< Sequence number of the next packet
+    uint64_t m_sent{0};           //!< Packets sent
+    uint64_t m_received{0};       //!< Echoes received
+    uint64_t m_rxBytes{0};        //!< Bytes of the echoes received
+    LatencyHistogram m_latencies; //!< Round trip times
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_ECHO_LOAD_CLIENT_H */
@@ -0,0 +1,266 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-delay-probe.h"
+
+#include "ns3/abort.h"
+#include "ns3/application.h"
+#include "ns3/log.h"
+#include "ns3/packet-sink.h"
+#include "ns3/simulator.h"
+#include "ns3/tag.h"
+
+#include <iomanip>
+#include <ostream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowDelayProbe");
+
+/**
+ * Byte tag of the packets measured by FlowDelayProbe.
+ */
+class FlowDelayTag : public Tag
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FlowDelayTag() = default;
+
+    /**
+     * @param flow the flow index
+     * @param seq the sequence number of the packet in the flow
+     * @param txTime the send time
+     */
+    FlowDelayTag(uint32_t flow, uint32_t seq, Time txTime);
+
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer buffer) const override;
+    void Deserialize(TagBuffer buffer) override;
+    void Print(std::ostream& os) const override;
+
+    uint32_t m_flow{0}; //!< Flow index
+    uint32_t m_seq{0};  //!< Sequence number
+    Time m_txTime;      //!< Send time
+};
+
+NS_OBJECT_ENSURE_REGISTERED(FlowDelayTag);
+
+TypeId
+FlowDelayTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FlowDelayTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Applications")
+                            .AddConstructor<FlowDelayTag>();
+    return tid;
+}
+
+FlowDelayTag::FlowDelayTag(uint32_t flow, uint32_t seq, Time txTime)
+    : m_flow(flow),
+      m_seq(seq),
+      m_txTime(txTime)
+{
+}
+
+TypeId
+FlowDelayTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+FlowDelayTag::GetSerializedSize() const
+{
+    return 16;
+}
+
+void
+FlowDelayTag::Serialize(TagBuffer buffer) const
+{
+    buffer.WriteU32(m_flow);
+    buffer.WriteU32(m_seq);
+    buffer.WriteU64(m_txTime.GetTimeStep());
+}
+
+void
+FlowDelayTag::Deserialize(TagBuffer buffer)
+{
+    m_flow = buffer.ReadU32();
+    m_seq = buffer.ReadU32();
+    m_txTime = TimeStep(buffer.ReadU64());
+}
+
+void
+FlowDelayTag::Print(std::ostream& os) const
+{
+    os << "flow=" << m_flow << " seq=" << m_seq << " txTime=" << m_txTime.As(Time::S);
+}
+
+FlowDelayProbe::FlowDelayProbe(uint32_t bits)
+    : m_bits(bits)
+{
+}
+
+uint32_t
+FlowDelayProbe::AddFlow(Ptr<Application> sender, const std::string& label)
+{
+    uint32_t index = m_flows.size();
+    NS_ABORT_MSG_UNLESS(
+        sender->TraceConnectWithoutContext("Tx",
+                                           MakeCallback(&FlowDelayProbe::Send, this).Bind(index)),
+        "Application " << sender->GetInstanceTypeId().GetName() << " has no Tx trace");
+    Flow flow;
+    flow.label = label;
+    flow.delays = LatencyHistogram(m_bits);
+    flow.jitter = LatencyHistogram(m_bits);
+    m_flows.push_back(std::move(flow));
+    return index;
+}
+
+void
+FlowDelayProbe::Connect(Ptr<PacketSink> sink)
+{
+    sink->TraceConnectWithoutContext("Rx", MakeCallback(&FlowDelayProbe::Receive, this));
+}
+
+void
+FlowDelayProbe::Flush()
+{
+    for (auto& flow : m_flows)
+    {
+        if (flow.receiving)
+        {
+            Complete(flow);
+        }
+    }
+}
+
+uint32_t
+FlowDelayProbe::GetNFlows() const
+{
+    return m_flows.size();
+}
+
+uint64_t
+FlowDelayProbe::GetNSent(uint32_t flow) const
+{
+    return m_flows.at(flow).nextSeq;
+}
+
+uint64_t
+FlowDelayProbe::GetNReceived(uint32_t flow) const
+{
+    return m_flows.at(flow).received;
+}
+
+const LatencyHistogram&
+FlowDelayProbe::GetDelays(uint32_t flow) const
+{
+    return m_flows.at(flow).delays;
+}
+
+const LatencyHistogram&
+FlowDelayProbe::GetJitter(uint32_t flow) const
+{
+    return m_flows.at(flow).jitter;
+}
+
+void
+FlowDelayProbe::Print(std::ostream& os) const
+{
+    auto ms = [](Time value) { return value.GetSeconds() * 1e3; };
+    os << "Flow\tsent\treceived\tlost\treordered\tdelay p50/p95/p99/max (ms)"
+          "\tjitter p50/p95/p99/max (ms)\n";
+    for (const auto& flow : m_flows)
+    {
+        os << flow.label << "\t" << flow.nextSeq << "\t" << flow.received << "\t" << flow.lost
+           << "\t" << flow.reordered;
+        for (const auto* histogram : {&flow.delays, &flow.jitter})
+        {
+            os << "\t" << ms(histogram->GetQuantile(0.5)) << "/"
+               << ms(histogram->GetQuantile(0.95)) << "/" << ms(histogram->GetQuantile(0.99))
+               << "/" << ms(histogram->GetMax());
+        }
+        os << "\n";
+    }
+    os.flush();
+}
+
+void
+FlowDelayProbe::Send(uint32_t flow, Ptr<const Packet> packet)
+{
+    // Byte tags can be added to a const packet
+    packet->AddByteTag(FlowDelayTag(flow, m_flows[flow].nextSeq++, Simulator::Now()));
+}
+
+void
+FlowDelayProbe::Receive(Ptr<const Packet> packet, const Address& from)
+{
+    static const TypeId tagType = FlowDelayTag::GetTypeId();
+    Time now = Simulator::Now();
+    ByteTagIterator it = packet->GetByteTagIterator();
+    while (it.HasNext())
+    {
+        ByteTagIterator::Item item = it.Next();
+        if (item.GetTypeId() != tagType)
+        {
+            continue;
+        }
+        FlowDelayTag tag;
+        item.GetTag(tag);
+        if (tag.m_flow >= m_flows.size())
+        {
+            continue;
+        }
+        Flow& flow = m_flows[tag.m_flow];
+        if (flow.receiving && tag.m_seq == flow.seq)
+        {
+            /* More bytes of the packet being received */
+            flow.lastRx = now;
+            continue;
+        }
+        if (flow.receiving)
+        {
+            Complete(flow);
+        }
+        flow.receiving = true;
+        flow.seq = tag.m_seq;
+        flow.txTime = tag.m_txTime;
+        flow.lastRx = now;
+        ++flow.received;
+        if (tag.m_seq >= flow.expected)
+        {
+            flow.lost += tag.m_seq - flow.expected;
+            flow.expected = tag.m_seq + 1;
+        }
+        else
+        {
+            ++flow.reordered;
+            flow.lost -= flow.lost > 0 ? 1 : 0;
+        }
+    }
+}
+
+void
+FlowDelayProbe::Complete(Flow& flow)
+{
+    Time delay = flow.lastRx - flow.txTime;
+    flow.delays.Add(delay);
+    if (flow.hasDelay)
+    {
+        flow.jitter.Add(Abs(delay - flow.lastDelay));
+    }
+    flow.hasDelay = true;
+    flow.lastDelay = delay;
+    flow.receiving = false;
+}
+
+} // namespace ns3
@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_FLOW_DELAY_PROBE_H
+#define SCRATCH_FLOW_DELAY_PROBE_H
+
+// Per-flow one-way delay, jitter, loss and reordering of application packets.
+
+#include "latency-histogram.h"
+
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Address;
+class Application;
+class PacketSink;
+
+/**
+ * Measures the one-way delay of the packets of every flow, from the "Tx"
+ * trace of its sending application to the "Rx" trace of a PacketSink.
+ *
+ * Each packet sent gets a byte tag holding its flow, its sequence number in
+ * the flow and its send time. Byte tags follow the bytes through TCP
+ * segmentation and reassembly, so the sink sees the tags of every packet
+ * whose bytes it receives; the delay of a packet is the time until its last
+ * byte is received. The flow comes from the tag, so any number of flows may
+ * share a sink and no lookup is needed.
+ *
+ * Per flow, the delays go to a fixed-memory LatencyHistogram, and the
+ * jitter, i.e. the absolute difference between the delays of consecutive
+ * packets (RFC 3393 IPDV), to another. A packet arriving after a later one
+ * counts as reordered, and the packets skipped by the sequence numbers as
+ * lost, until they arrive. TCP delivers in order and without loss, so these
+ * stay zero unless the flow is cut; head-of-line blocking shows in the delay.
+ *
+ * The cost is one tag per packet sent and one tag scan per packet received,
+ * with O(1) state per flow besides its two histograms, whose precision is
+ * set for the number of flows (5 bits, within 3% and about 8 KB each, by
+ * default).
+ */
+class FlowDelayProbe
+{
+  public:
+    /**
+     * @param bits the precision of the histograms (see LatencyHistogram)
+     */
+    explicit FlowDelayProbe(uint32_t bits = 5);
+
+    /**
+     * Add a flow and tag the packets of its sender.
+     *
+     * @param sender an application with a "Tx" trace source of Ptr<const Packet>,
+     *        e.g. OnOffApplication or SaturatingSender
+     * @param label the label used when reporting the flow
+     * @return the index of the flow
+     */
+    uint32_t AddFlow(Ptr<Application> sender, const std::string& label);
+
+    /**
+     * Measure the tagged packets received by a sink.
+     *
+     * @param sink the sink application
+     */
+    void Connect(Ptr<PacketSink> sink);
+
+    /**
+     * Account for the packets whose last byte was received. Call it once
+     * after Simulator::Run().
+     */
+    void Flush();
+
+    /**
+     * @return the number of flows
+     */
+    uint32_t GetNFlows() const;
+
+    /**
+     * @param flow the flow index
+     * @return the number of packets sent by the flow
+     */
+    uint64_t GetNSent(uint32_t flow) const;
+
+    /**
+     * @param flow the flow index
+     * @return the number of packets of the flow received
+     */
+    uint64_t GetNReceived(uint32_t flow) const;
+
+    /**
+     * @param flow the flow index
+     * @return the delays of the flow
+     */
+    const LatencyHistogram& GetDelays(uint32_t flow) const;
+
+    /**
+     * @param flow the flow index
+     * @return the jitter of the flow
+     */
+    const LatencyHistogram& GetJitter(uint32_t flow) const;
+
+    /**
+     * Print one line per flow: packets sent and received, lost and reordered,
+     * delay and jitter percentiles (p50, p95, p99 and maximum) in ms.
+     *
+     * @param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /// State of a flow
+    struct Flow
+    {
+        std::string label;       //!< Label of the flow
+        uint32_t nextSeq{0};     //!< Sequence number of the next packet sent
+        bool receiving{false};   //!< Whether the bytes of a packet were received
+        uint32_t seq{0};         //!< Sequence number of that packet
+        Time txTime;             //!< Send time of that packet
+        Time lastRx;             //!< Time at which its last bytes so far were received
+        uint32_t expected{0};    //!< Sequence number after the highest received
+        uint64_t received{0};    //!< Packets received
+        uint64_t lost{0};        //!< Packets skipped and not received yet
+        uint64_t reordered{0};   //!< Packets received after a later one
+        bool hasDelay{false};    //!< Whether a delay was recorded
+        Time lastDelay;          //!< Last delay recorded
+        LatencyHistogram delays; //!< One-way delays
+        LatencyHistogram jitter; //!< Delay variations between consecutive packets
+    };
+
+    /**
+     * Trace sink for the "Tx" trace of a sender.
+     *
+     * @param flow the flow index
+     * @param packet the packet sent
+     */
+    void Send(uint32_t flow, Ptr<const Packet> packet);
+
+    /**
+     * Trace sink for PacketSink::Rx.
+     *
+     * @param packet the received bytes
+     * @param from the source address
+     */
+    void Receive(Ptr<const Packet> packet, const Address& from);
+
+    /**
+     * Record the delay of the packet being received by a flow.
+     *
+     * @param flow the flow
+     */
+    void Complete(Flow& flow);
+
+    uint32_t m_bits;           //!< Precision of the histograms
+    std::vector<Flow> m_flows; //!< Flows, by index
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_FLOW_DELAY_PROBE_H */
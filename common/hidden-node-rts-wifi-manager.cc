@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "hidden-node-rts-wifi-manager.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-utils.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("HiddenNodeRtsWifiManager");
+
+NS_OBJECT_ENSURE_REGISTERED(HiddenNodeRtsWifiManager);
+
+TypeId
+HiddenNodeRtsWifiManager::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HiddenNodeRtsWifiManager")
+            .SetParent<ConstantRateWifiManager>()
+            .SetGroupName("Wifi")
+            .AddConstructor<HiddenNodeRtsWifiManager>()
+            .AddAttribute("LossThreshold",
+                          "Consecutive lost transmissions to a peer enabling RTS/CTS for it",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&HiddenNodeRtsWifiManager::m_lossThreshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MinSnr",
+                          "SNR (dB) of the peer above which losses are put down to collisions",
+                          DoubleValue(15),
+                          MakeDoubleAccessor(&HiddenNodeRtsWifiManager::m_minSnr),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("HoldTime",
+                          "Initial length of the periods during which RTS/CTS is used",
+                          TimeValue(MilliSeconds(500)),
+                          MakeTimeAccessor(&HiddenNodeRtsWifiManager::m_holdTime),
+                          MakeTimeChecker(Time(1)))
+            .AddAttribute("MaxHoldTime",
+                          "Maximum length of the periods during which RTS/CTS is used",
+                          TimeValue(Seconds(8)),
+                          MakeTimeAccessor(&HiddenNodeRtsWifiManager::m_maxHoldTime),
+                          MakeTimeChecker(Time(1)))
+            .AddAttribute("ProbeWindow",
+                          "Time after the end of a period within which enabling RTS/CTS again "
+                          "doubles the length of the next period",
+                          TimeValue(MilliSeconds(200)),
+                          MakeTimeAccessor(&HiddenNodeRtsWifiManager::m_probeWindow),
+                          MakeTimeChecker())
+            .AddTraceSource("RtsProtection",
+                            "RTS/CTS was enabled or disabled for a peer",
+                            MakeTraceSourceAccessor(&HiddenNodeRtsWifiManager::m_protectionTrace),
+                            "ns3::HiddenNodeRtsWifiManager::ProtectionTracedCallback");
+    return tid;
+}
+
+HiddenNodeRtsWifiManager::HiddenNodeRtsWifiManager() = default;
+
+HiddenNodeRtsWifiManager::~HiddenNodeRtsWifiManager() = default;
+
+uint32_t
+HiddenNodeRtsWifiManager::GetNActivations() const
+{
+    return m_nActivations;
+}
+
+WifiRemoteStation*
+HiddenNodeRtsWifiManager::DoCreateStation() const
+{
+    return new Station();
+}
+
+bool
+HiddenNodeRtsWifiManager::DoNeedRts(WifiRemoteStation* st, uint32_t size, bool normally)
+{
+    auto station = static_cast<Station*>(st);
+    if (station->protect && Simulator::Now() >= station->until)
+    {
+        /* Probe whether the peer still needs it */
+        station->protect = false;
+        station->losses = 0;
+        station->lastOff = Simulator::Now();
+        NS_LOG_DEBUG("RTS/CTS disabled for " << station->m_state->m_address);
+        m_protectionTrace(station->m_state->m_address, false);
+    }
+    return normally || station->protect;
+}
+
+void
+HiddenNodeRtsWifiManager::DoReportRxOk(WifiRemoteStation* st, double rxSnr, WifiMode txMode)
+{
+    static_cast<Station*>(st)->snr = rxSnr;
+}
+
+void
+HiddenNodeRtsWifiManager::DoReportDataFailed(WifiRemoteStation* st)
+{
+    Lost(static_cast<Station*>(st));
+}
+
+void
+HiddenNodeRtsWifiManager::DoReportDataOk(WifiRemoteStation* st,
+                                         double ackSnr,
+                                         WifiMode ackMode,
+                                         double dataSnr,
+                                         MHz_u dataChannelWidth,
+                                         uint8_t dataNss)
+{
+    Acknowledged(static_cast<Station*>(st), ackSnr);
+}
+
+void
+HiddenNodeRtsWifiManager::DoReportAmpduTxStatus(WifiRemoteStation* st,
+                                                uint16_t nSuccessfulMpdus,
+                                                uint16_t nFailedMpdus,
+                                                double rxSnr,
+                                                double dataSnr,
+                                                MHz_u dataChannelWidth,
+                                                uint8_t dataNss)
+{
+    auto station = static_cast<Station*>(st);
+    if (nSuccessfulMpdus == 0)
+    {
+        Lost(station);
+    }
+    else
+    {
+        Acknowledged(station, rxSnr);
+    }
+}
+
+void
+HiddenNodeRtsWifiManager::Lost(Station* station)
+{
+    ++station->losses;
+    if (station->protect || station->losses < m_lossThreshold ||
+        RatioToDb(station->snr) < m_minSnr)
+    {
+        return;
+    }
+    Time now = Simulator::Now();
+    bool probeFailed = station->hold.IsStrictlyPositive() && now - station->lastOff < m_probeWindow;
+    station->hold = probeFailed ? std::min(station->hold * 2, m_maxHoldTime) : m_holdTime;
+    station->until = now + station->hold;
+    station->protect = true;
+    ++m_nActivations;
+    NS_LOG_DEBUG("RTS/CTS enabled for " << station->m_state->m_address << " during "
+                                        << station->hold.As(Time::MS));
+    m_protectionTrace(station->m_state->m_address, true);
+}
+
+void
+HiddenNodeRtsWifiManager::Acknowledged(Station* station, double snr)
+{
+    station->losses = 0;
+    if (snr > 0)
+    {
+        station->snr = snr;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_HIDDEN_NODE_RTS_WIFI_MANAGER_H
+#define SCRATCH_HIDDEN_NODE_RTS_WIFI_MANAGER_H
+
+// Constant rate station manager enabling RTS/CTS per peer when its transmissions collide.
+
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/mac48-address.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * ConstantRateWifiManager that protects the transmissions to a peer with
+ * RTS/CTS only while they suffer from hidden nodes.
+ *
+ * A transmission is lost when its ACK or BlockAck is missing, or when the
+ * BlockAck acknowledges none of the MPDUs. After LossThreshold consecutive
+ * losses to a peer whose last reported SNR (of its ACKs, BlockAcks and other
+ * frames) is at least MinSnr, the losses are put down to collisions rather
+ * than to the channel and RTS/CTS is used for that peer during HoldTime.
+ * Then the manager probes without RTS/CTS again; if it has to enable RTS/CTS
+ * again within ProbeWindow, the next period lasts twice as long (up to
+ * MaxHoldTime), and otherwise it starts again from HoldTime. Peers whose
+ * transmissions do not collide, e.g. because every station hears the others,
+ * keep sending without RTS/CTS.
+ *
+ * The RtsCtsThreshold attribute still applies: the frames above it are
+ * protected in any case.
+ */
+class HiddenNodeRtsWifiManager : public ConstantRateWifiManager
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    HiddenNodeRtsWifiManager();
+    ~HiddenNodeRtsWifiManager() override;
+
+    /**
+     * @return the number of times RTS/CTS was enabled for a peer
+     */
+    uint32_t GetNActivations() const;
+
+    /**
+     * TracedCallback signature for the protection changes.
+     *
+     * @param peer the address of the peer
+     * @param enabled whether RTS/CTS is now used for the peer
+     */
+    typedef void (*ProtectionTracedCallback)(Mac48Address peer, bool enabled);
+
+  private:
+    /// State kept per peer
+    struct Station : public WifiRemoteStation
+    {
+        uint32_t losses{0};  //!< Consecutive lost transmissions
+        double snr{0};       //!< Last SNR reported for the peer (linear)
+        bool protect{false}; //!< Whether RTS/CTS is used
+        Time until;          //!< End of the RTS/CTS period
+        Time hold;           //!< Length of the last RTS/CTS period
+        Time lastOff;        //!< Time at which RTS/CTS was last disabled
+    };
+
+    WifiRemoteStation* DoCreateStation() const override;
+    bool DoNeedRts(WifiRemoteStation* station, uint32_t size, bool normally) override;
+    void DoReportRxOk(WifiRemoteStation* station, double rxSnr, WifiMode txMode) override;
+    void DoReportDataFailed(WifiRemoteStation* station) override;
+    void DoReportDataOk(WifiRemoteStation* station,
+                        double ackSnr,
+                        WifiMode ackMode,
+                        double dataSnr,
+                        MHz_u dataChannelWidth,
+                        uint8_t dataNss) override;
+    void DoReportAmpduTxStatus(WifiRemoteStation* station,
+                               uint16_t nSuccessfulMpdus,
+                               uint16_t nFailedMpdus,
+                               double rxSnr,
+                               double dataSnr,
+                               MHz_u dataChannelWidth,
+                               uint8_t dataNss) override;
+
+    /**
+     * Count a lost transmission, and enable RTS/CTS once the losses point to a hidden node.
+     *
+     * @param station the peer
+     */
+    void Lost(Station* station);
+
+    /**
+     * Record a successful transmission.
+     *
+     * @param station the peer
+     * @param snr the SNR of the acknowledgment (linear), 0 if unknown
+     */
+    void Acknowledged(Station* station, double snr);
+
+    uint32_t m_lossThreshold; //!< Consecutive losses enabling RTS/CTS
+    double m_minSnr;          //!< SNR (dB) above which losses are put down to collisions
+    Time m_holdTime;          //!< Initial length of an RTS/CTS period
+    Time m_maxHoldTime;       //!< Maximum length of an RTS/CTS period
+    Time m_probeWindow;       //!< Period after a probe within which the length doubles
+
+    uint32_t m_nActivations{0}; //!< Times RTS/CTS was enabled
+
+    /// Changes of the protection of a peer
+    TracedCallback<Mac48Address, bool> m_protectionTrace;
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_HIDDEN_NODE_RTS_WIFI_MANAGER_H */
@@ -0,0 +1,120 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "latency-histogram.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+LatencyHistogram::LatencyHistogram(uint32_t bits)
+    : m_bits(bits)
+{
+    NS_ABORT_MSG_IF(bits < 2 || bits > 16, "The precision must be 2 to 16 bits");
+    m_counts.resize((std::size_t{1} << bits) + (64 - bits) * (std::size_t{1} << (bits - 1)), 0);
+}
+
+void
+LatencyHistogram::Add(Time value)
+{
+    uint64_t ns = value.IsStrictlyPositive() ? value.GetNanoSeconds() : 0;
+    ++m_counts[GetIndex(ns)];
+    ++m_count;
+    m_min = std::min(m_min, ns);
+    m_max = std::max(m_max, ns);
+    m_sum += ns;
+}
+
+void
+LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    NS_ABORT_MSG_IF(other.m_bits != m_bits, "Cannot merge histograms of different precisions");
+    for (std::size_t i = 0; i < m_counts.size(); ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_sum += other.m_sum;
+}
+
+uint64_t
+LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+Time
+LatencyHistogram::GetMin() const
+{
+    return m_count == 0 ? Time(0) : NanoSeconds(m_min);
+}
+
+Time
+LatencyHistogram::GetMax() const
+{
+    return NanoSeconds(m_max);
+}
+
+Time
+LatencyHistogram::GetMean() const
+{
+    return m_count == 0 ? Time(0) : NanoSeconds(std::llround(m_sum / m_count));
+}
+
+Time
+LatencyHistogram::GetQuantile(double q) const
+{
+    if (m_count == 0)
+    {
+        return Time(0);
+    }
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * m_count));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < m_counts.size(); ++i)
+    {
+        seen += m_counts[i];
+        if (seen >= rank)
+        {
+            return NanoSeconds(std::clamp(GetMiddle(i), m_min, m_max));
+        }
+    }
+    return NanoSeconds(m_max);
+}
+
+std::size_t
+LatencyHistogram::GetIndex(uint64_t ns) const
+{
+    if (ns < (uint64_t{1} << m_bits))
+    {
+        return ns;
+    }
+    // ns >> shift keeps the top m_bits bits, the first of which is set
+    uint32_t exponent = 63 - __builtin_clzll(ns);
+    uint32_t shift = exponent - (m_bits - 1);
+    uint64_t half = uint64_t{1} << (m_bits - 1);
+    return (std::size_t{1} << m_bits) + (exponent - m_bits) * half + ((ns >> shift) - half);
+}
+
+uint64_t
+LatencyHistogram::GetMiddle(std::size_t index) const
+{
+    if (index < (std::size_t{1} << m_bits))
+    {
+        return index;
+    }
+    uint64_t half = uint64_t{1} << (m_bits - 1);
+    uint64_t offset = index - (std::size_t{1} << m_bits);
+    uint32_t shift = offset / half + 1;
+    uint64_t low = (half + offset % half) << shift;
+    return low + (uint64_t{1} << (shift - 1));
+}
+
+} // namespace ns3
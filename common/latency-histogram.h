@@ -0,0 +1,98 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_LATENCY_HISTOGRAM_H
+#define SCRATCH_LATENCY_HISTOGRAM_H
+
+// Fixed-memory histogram of latencies with logarithmic buckets.
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Histogram of non-negative durations, at nanosecond resolution, whose
+ * buckets keep a bounded relative error: values below 2^bits ns have one
+ * bucket each, and every power of two above is split into 2^(bits - 1)
+ * buckets of equal width. With the default 7 bits a quantile is within
+ * 0.8% of the exact one, and the histogram holds 57 * 64 + 128 counters
+ * (30 KB) whatever the number of values and their range (up to 2^64 ns).
+ */
+class LatencyHistogram
+{
+  public:
+    /**
+     * @param bits the precision: buckets per power of two are 2^(bits - 1), from 2 to 16 bits
+     */
+    explicit LatencyHistogram(uint32_t bits = 7);
+
+    /**
+     * Add a value; negative values count as zero.
+     *
+     * @param value the value
+     */
+    void Add(Time value);
+
+    /**
+     * Add the values of another histogram of the same precision.
+     *
+     * @param other the other histogram
+     */
+    void Merge(const LatencyHistogram& other);
+
+    /**
+     * @return the number of values
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * @return the smallest value, zero if empty
+     */
+    Time GetMin() const;
+
+    /**
+     * @return the largest value, zero if empty
+     */
+    Time GetMax() const;
+
+    /**
+     * @return the exact mean of the values, zero if empty
+     */
+    Time GetMean() const;
+
+    /**
+     * @param q the quantile, in [0, 1], e.g. 0.99
+     * @return the middle of the bucket holding the value of rank ceil(q * count),
+     *         within the minimum and maximum, zero if empty
+     */
+    Time GetQuantile(double q) const;
+
+  private:
+    /**
+     * @param ns a value in ns
+     * @return the index of its bucket
+     */
+    std::size_t GetIndex(uint64_t ns) const;
+
+    /**
+     * @param index the index of a bucket
+     * @return the middle of the bucket in ns
+     */
+    uint64_t GetMiddle(std::size_t index) const;
+
+    uint32_t m_bits;                //!< Precision
+    std::vector<uint64_t> m_counts; //!< Values in each bucket
+    uint64_t m_count{0};            //!< Number of values
+    uint64_t m_min{UINT64_MAX};     //!< Smallest value in ns
+    uint64_t m_max{0};              //!< Largest value in ns
+    double m_sum{0};                //!< Sum of the values in ns
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_LATENCY_HISTOGRAM_H */
@@ -0,0 +1,242 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "process-pool.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// A child started by the pool and not yet reaped
+struct RunningChild
+{
+    pid_t pid;                                   //!< Process id
+    int fd;                                      //!< Read end of the output pipe
+    std::size_t index;                           //!< Index of the command
+    std::chrono::steady_clock::time_point start; //!< Time of the fork
+};
+
+/**
+ * Fork and exec one command with stdout and stderr redirected to a pipe.
+ *
+ * @param command the argv vector
+ * @param readFd receives the read end of the pipe
+ * @return the pid of the child, or -1 on failure
+ */
+pid_t
+Spawn(const std::vector<std::string>& command, int& readFd)
+{
+    // Build argv before forking: the child must not allocate.
+    std::vector<char*> argv;
+    argv.reserve(command.size() + 1);
+    for (const auto& arg : command)
+    {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // Close-on-exec keeps the pipes of one child out of its siblings
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0)
+    {
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        dup2(fds[1], STDERR_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    close(fds[1]);
+    if (pid < 0)
+    {
+        close(fds[0]);
+        return -1;
+    }
+    readFd = fds[0];
+    return pid;
+}
+
+/**
+ * Close the pipe of a child, wait for its exit and record its exit code,
+ * peak RSS and wall time.
+ *
+ * @param child the child
+ * @param result the result of its command
+ */
+void
+Reap(const RunningChild& child, ProcessResult& result)
+{
+    close(child.fd);
+    int status = 0;
+    rusage usage{};
+    while (wait4(child.pid, &status, 0, &usage) < 0 && errno == EINTR)
+    {
+    }
+    result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    result.peakRssKb = usage.ru_maxrss;
+    result.wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - child.start).count();
+}
+
+} // namespace
+
+std::vector<ProcessResult>
+RunProcessPool(const std::vector<std::vector<std::string>>& commands,
+               unsigned jobs,
+               const std::function<void(std::size_t, const ProcessResult&)>& progress)
+{
+    if (jobs == 0)
+    {
+        jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    std::vector<ProcessResult> results(commands.size());
+    std::vector<RunningChild> running;
+    std::vector<pollfd> pollFds;
+    std::vector<char> buffer(64 * 1024);
+    std::size_t next = 0;
+
+    while (next < commands.size() || !running.empty())
+    {
+        while (running.size() < jobs && next < commands.size())
+        {
+            int fd = -1;
+            auto start = std::chrono::steady_clock::now();
+            pid_t pid = commands[next].empty() ? -1 : Spawn(commands[next], fd);
+            if (pid < 0)
+            {
+                results[next].output = "failed to start process";
+                if (progress)
+                {
+                    progress(next, results[next]);
+                }
+            }
+            else
+            {
+                results[next].startTime =
+                    std::chrono::duration<double>(start.time_since_epoch()).count();
+                running.push_back({pid, fd, next, start});
+            }
+            ++next;
+        }
+        if (running.empty())
+        {
+            continue;
+        }
+
+        pollFds.clear();
+        for (const auto& child : running)
+        {
+            pollFds.push_back({child.fd, POLLIN, 0});
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // The children can no longer be read: kill them rather than leave them behind
+            std::string error = std::string("poll failed: ") + std::strerror(errno);
+            for (const auto& child : running)
+            {
+                kill(child.pid, SIGKILL);
+                Reap(child, results[child.index]);
+                results[child.index].output += "\n" + error;
+                if (progress)
+                {
+                    progress(child.index, results[child.index]);
+                }
+            }
+            running.clear();
+            for (; next < commands.size(); ++next)
+            {
+                results[next].output = "not started, " + error;
+                if (progress)
+                {
+                    progress(next, results[next]);
+                }
+            }
+            break;
+        }
+
+        // Walk backwards so that finished children can be erased in place
+        for (std::size_t i = running.size(); i-- > 0;)
+        {
+            if (pollFds[i].revents == 0)
+            {
+                continue;
+            }
+            auto& child = running[i];
+            ssize_t n = read(child.fd, buffer.data(), buffer.size());
+            if (n > 0)
+            {
+                results[child.index].output.append(buffer.data(), n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            // End of output: the child has exited or is about to
+            Reap(child, results[child.index]);
+            if (progress)
+            {
+                progress(child.index, results[child.index]);
+            }
+            running.erase(running.begin() + i);
+        }
+    }
+    return results;
+}
+
+std::string
+GetSiblingExecutable(const std::string& selfName,
+                     const std::string& targetName,
+                     const std::string& relativeDirectory)
+{
+    char path[4096];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0)
+    {
+        return "";
+    }
+    std::string self(path, length);
+    auto slash = self.rfind('/');
+    std::string directory = self.substr(0, slash + 1);
+    std::string file = self.substr(slash + 1);
+    auto position = file.rfind(selfName);
+    if (position == std::string::npos)
+    {
+        return "";
+    }
+    file.replace(position, selfName.size(), targetName);
+    if (!relativeDirectory.empty())
+    {
+        directory += relativeDirectory + "/";
+    }
+    return directory + file;
+}
+
+} // namespace ns3
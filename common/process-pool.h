@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_PROCESS_POOL_H
+#define SCRATCH_PROCESS_POOL_H
+
+// Runs many short-lived child processes (typically scenario binaries) in
+// parallel and collects their console output.
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Outcome of one child process started by RunProcessPool().
+ */
+struct ProcessResult
+{
+    int exitCode{-1};      //!< Exit code, or -1 if the child did not exit normally
+    std::string output;    //!< Everything the child wrote to stdout and stderr
+    double wallSeconds{0}; //!< Wall-clock time from fork to exit
+    long peakRssKb{0};     //!< Peak resident set size of the child in KiB
+    double startTime{0};   //!< steady_clock time of the fork in seconds
+};
+
+/**
+ * Run a list of commands as child processes, keeping at most @p jobs of them
+ * alive at any time.
+ *
+ * The children are multiplexed with poll() from the calling thread, so no
+ * worker threads are involved and the pool itself costs nothing while the
+ * children are busy simulating.
+ *
+ * @param commands argv vectors; the first element is the path of the program
+ * @param jobs maximum number of concurrent children (0 selects the number of cores)
+ * @param progress if set, invoked from the calling thread each time a command
+ *        finishes, with the index of the command and its result
+ * @return one result per command, in the order of @p commands
+ */
+std::vector<ProcessResult> RunProcessPool(
+    const std::vector<std::vector<std::string>>& commands,
+    unsigned jobs,
+    const std::function<void(std::size_t, const ProcessResult&)>& progress = {});
+
+/**
+ * Get the path of an executable built next to the running one.
+ *
+ * ns-3 names executables "<prefix><name><suffix>" (e.g. "ns3.45-q3-default").
+ * This replaces @p selfName in the file name of the running executable with
+ * @p targetName and resolves the result relative to @p relativeDirectory.
+ *
+ * @param selfName the base name of the running executable (e.g. "q3-sweep")
+ * @param targetName the base name of the wanted executable (e.g. "q3")
+ * @param relativeDirectory directory of the target relative to the running executable
+ * @return the path of the target, or an empty string if it cannot be derived
+ */
+std::string GetSiblingExecutable(const std::string& selfName,
+                                 const std::string& targetName,
+                                 const std::string& relativeDirectory);
+
+} // namespace ns3
+
+#endif /* SCRATCH_PROCESS_POOL_H */
@@ -0,0 +1,390 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "profiling-simulator-impl.h"
+
+#include "ns3/default-simulator-impl.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ProfilingSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(ProfilingSimulatorImpl);
+
+namespace
+{
+
+/**
+ * @return the value of a cheap monotonic counter: the time stamp counter on
+ *         x86, nanoseconds elsewhere
+ */
+inline uint64_t
+ReadCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/**
+ * Remove every occurrence of a substring.
+ *
+ * @param text the text
+ * @param pattern the substring
+ */
+void
+EraseAll(std::string& text, const std::string& pattern)
+{
+    for (auto position = text.find(pattern); position != std::string::npos;
+         position = text.find(pattern, position))
+    {
+        text.erase(position, pattern.size());
+    }
+}
+
+} // namespace
+
+/**
+ * Times the event it wraps and charges it to a site of the simulator.
+ */
+class ProfilingSimulatorImpl::ProfiledEvent : public EventImpl
+{
+  public:
+    /**
+     * @param simulator the profiling simulator
+     * @param event the wrapped event, whose reference is taken over
+     * @param site the index of the site of the event
+     */
+    ProfiledEvent(ProfilingSimulatorImpl* simulator, EventImpl* event, uint32_t site)
+        : m_simulator(simulator),
+          m_event(event, false),
+          m_site(site)
+    {
+    }
+
+  protected:
+    void Notify() override
+    {
+        // Events scheduled by the wrapped one are charged to its site
+        uint32_t previous = m_simulator->m_current;
+        m_simulator->m_current = m_site;
+        uint64_t start = ReadCycles();
+        m_event->Invoke();
+        uint64_t cycles = ReadCycles() - start;
+        Site& site = m_simulator->m_sites[m_site];
+        ++site.events;
+        site.cycles += cycles;
+        m_simulator->m_current = previous;
+    }
+
+  private:
+    ProfilingSimulatorImpl* m_simulator; //!< Profiling simulator
+    Ptr<EventImpl> m_event;              //!< Wrapped event
+    uint32_t m_site;                     //!< Site of the event
+};
+
+TypeId
+ProfilingSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ProfilingSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Core")
+            .AddConstructor<ProfilingSimulatorImpl>()
+            .AddAttribute("TopN",
+                          "Number of callback types listed in the report",
+                          UintegerValue(20),
+                          MakeUintegerAccessor(&ProfilingSimulatorImpl::m_topN),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FoldedFile",
+                          "File receiving the folded stacks, none if empty",
+                          StringValue("simulator-profile.folded"),
+                          MakeStringAccessor(&ProfilingSimulatorImpl::m_foldedFile),
+                          MakeStringChecker());
+    return tid;
+}
+
+ProfilingSimulatorImpl::ProfilingSimulatorImpl()
+    : m_impl(CreateObject<DefaultSimulatorImpl>())
+{
+}
+
+ProfilingSimulatorImpl::~ProfilingSimulatorImpl() = default;
+
+void
+ProfilingSimulatorImpl::Destroy()
+{
+    m_impl->Destroy();
+    if (!m_reported)
+    {
+        m_reported = true;
+        Report(std::clog);
+        WriteFolded();
+    }
+}
+
+bool
+ProfilingSimulatorImpl::IsFinished() const
+{
+    return m_impl->IsFinished();
+}
+
+void
+ProfilingSimulatorImpl::Stop()
+{
+    m_impl->Stop();
+}
+
+EventId
+ProfilingSimulatorImpl::Stop(const Time& delay)
+{
+    return m_impl->Stop(delay);
+}
+
+EventId
+ProfilingSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    return m_impl->Schedule(delay, Wrap(event));
+}
+
+void
+ProfilingSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event)
+{
+    m_impl->ScheduleWithContext(context, delay, Wrap(event));
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return m_impl->ScheduleNow(Wrap(event));
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    return m_impl->ScheduleDestroy(event);
+}
+
+void
+ProfilingSimulatorImpl::Remove(const EventId& id)
+{
+    m_impl->Remove(id);
+}
+
+void
+ProfilingSimulatorImpl::Cancel(const EventId& id)
+{
+    m_impl->Cancel(id);
+}
+
+bool
+ProfilingSimulatorImpl::IsExpired(const EventId& id) const
+{
+    return m_impl->IsExpired(id);
+}
+
+void
+ProfilingSimulatorImpl::Run()
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startCycles = ReadCycles();
+    m_impl->Run();
+    m_runCycles += ReadCycles() - startCycles;
+    m_runSeconds +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Time
+ProfilingSimulatorImpl::Now() const
+{
+    return m_impl->Now();
+}
+
+Time
+ProfilingSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    return m_impl->GetDelayLeft(id);
+}
+
+Time
+ProfilingSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return m_impl->GetMaximumSimulationTime();
+}
+
+void
+ProfilingSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    m_impl->SetScheduler(schedulerFactory);
+}
+
+uint32_t
+ProfilingSimulatorImpl::GetSystemId() const
+{
+    return m_impl->GetSystemId();
+}
+
+uint32_t
+ProfilingSimulatorImpl::GetContext() const
+{
+    return m_impl->GetContext();
+}
+
+uint64_t
+ProfilingSimulatorImpl::GetEventCount() const
+{
+    return m_impl->GetEventCount();
+}
+
+void
+ProfilingSimulatorImpl::Report(std::ostream& os) const
+{
+    // Sites are merged by name: a type can have several type_info objects across libraries
+    struct Total
+    {
+        uint64_t events{0};
+        uint64_t cycles{0};
+    };
+    std::map<std::string, Total> totals;
+    Total all;
+    for (const auto& site : m_sites)
+    {
+        auto& total = totals[GetName(*site.type)];
+        total.events += site.events;
+        total.cycles += site.cycles;
+        all.events += site.events;
+        all.cycles += site.cycles;
+    }
+    std::vector<std::pair<std::string, Total>> rows(totals.begin(), totals.end());
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.second.cycles > b.second.cycles;
+    });
+
+    double secondsPerCycle = m_runCycles > 0 ? m_runSeconds / m_runCycles : 0;
+    os << "Event profile: " << all.events << " events, " << all.cycles * secondsPerCycle
+       << " s in events, " << (m_runCycles - std::min(m_runCycles, all.cycles)) * secondsPerCycle
+       << " s in the scheduler, " << m_runSeconds << " s in Simulator::Run()\n";
+    os << std::setw(10) << "seconds" << std::setw(8) << "share" << std::setw(12) << "events"
+       << std::setw(10) << "ns/event"
+       << "  callback\n";
+    for (std::size_t i = 0; i < rows.size() && i < m_topN; ++i)
+    {
+        const auto& [name, total] = rows[i];
+        double seconds = total.cycles * secondsPerCycle;
+        os << std::fixed << std::setprecision(3) << std::setw(10) << seconds << std::setw(7)
+           << std::setprecision(1) << (all.cycles > 0 ? 100.0 * total.cycles / all.cycles : 0)
+           << "%" << std::setw(12) << total.events << std::setw(10) << std::setprecision(0)
+           << (total.events > 0 ? 1e9 * seconds / total.events : 0) << "  " << name << "\n";
+    }
+    os << std::defaultfloat << std::setprecision(6) << std::flush;
+}
+
+void
+ProfilingSimulatorImpl::DoDispose()
+{
+    m_impl = nullptr;
+    SimulatorImpl::DoDispose();
+}
+
+EventImpl*
+ProfilingSimulatorImpl::Wrap(EventImpl* event)
+{
+    SiteKey key{m_current, &typeid(*event)};
+    auto [it, inserted] = m_siteKeys.emplace(key, m_sites.size());
+    if (inserted)
+    {
+        m_sites.push_back({key.first, key.second});
+    }
+    return new ProfiledEvent(this, event, it->second);
+}
+
+void
+ProfilingSimulatorImpl::WriteFolded() const
+{
+    if (m_foldedFile.empty())
+    {
+        return;
+    }
+    std::ofstream file(m_foldedFile);
+    if (!file)
+    {
+        NS_LOG_WARN("Cannot open " << m_foldedFile);
+        return;
+    }
+    double secondsPerCycle = m_runCycles > 0 ? m_runSeconds / m_runCycles : 0;
+    std::map<std::string, double> stacks;
+    for (const auto& site : m_sites)
+    {
+        std::string parent =
+            site.parent == NO_SITE ? "setup" : GetName(*m_sites[site.parent].type);
+        stacks[parent + ";" + GetName(*site.type)] += site.cycles * secondsPerCycle * 1e6;
+    }
+    for (const auto& [stack, microseconds] : stacks)
+    {
+        file << stack << " " << static_cast<uint64_t>(microseconds + 0.5) << "\n";
+    }
+}
+
+std::string
+ProfilingSimulatorImpl::GetName(const std::type_info& type)
+{
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : type.name();
+    std::free(demangled);
+
+    // MakeEvent() defines its event classes locally: keep the function type,
+    // its first template argument
+    const std::string makeEvent = "MakeEvent<";
+    auto start = name.find(makeEvent);
+    if (start != std::string::npos)
+    {
+        start += makeEvent.size();
+        int depth = 0;
+        std::size_t end = start;
+        for (; end < name.size(); ++end)
+        {
+            char c = name[end];
+            if (c == '<' || c == '(')
+            {
+                ++depth;
+            }
+            else if (c == ')' || (c == '>' && depth > 0))
+            {
+                --depth;
+            }
+            else if ((c == ',' || c == '>') && depth == 0)
+            {
+                break;
+            }
+        }
+        name = name.substr(start, end - start);
+    }
+    EraseAll(name, "ns3::");
+    // Folded stacks separate frames with semicolons and the count with a space
+    std::replace(name.begin(), name.end(), ';', ',');
+    return name;
+}
+
+} // namespace ns3
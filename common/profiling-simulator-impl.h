@@ -0,0 +1,153 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_PROFILING_SIMULATOR_IMPL_H
+#define SCRATCH_PROFILING_SIMULATOR_IMPL_H
+
+// Simulator implementation measuring where the event processing time goes.
+
+#include "ns3/event-impl.h"
+#include "ns3/simulator-impl.h"
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Simulator implementation that runs a DefaultSimulatorImpl and times every
+ * event it executes. Select it before the simulator is first used, with
+ * --SimulatorImplementationType=ns3::ProfilingSimulatorImpl or
+ * GlobalValue::Bind().
+ *
+ * Every scheduled event is wrapped into an event that reads the cycle
+ * counter around the original one. Events are attributed to their callback
+ * type (the dynamic type of the EventImpl built by MakeEvent(), which names
+ * the class and signature of the function, or the lambda) and to the type
+ * of the event that was executing when they were scheduled, i.e. their
+ * scheduling site; events scheduled before Simulator::Run() have the site
+ * "setup". The cost is one hash lookup per Schedule() and two counter reads
+ * per event.
+ *
+ * At Simulator::Destroy() the TopN callback types by time are printed to
+ * std::clog, and if FoldedFile is not empty, the time of every pair of
+ * scheduling site and callback type is written in the folded format of
+ * flame graph tools ("site type;callback type microseconds", the site being
+ * "setup" for the events scheduled before the simulation).
+ */
+class ProfilingSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    ProfilingSimulatorImpl();
+    ~ProfilingSimulatorImpl() override;
+
+    // Inherited from SimulatorImpl
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Print the TopN callback types by time.
+     *
+     * @param os the output stream
+     */
+    void Report(std::ostream& os) const;
+
+  private:
+    /// Events and cycles of one pair of scheduling site and callback type
+    struct Site
+    {
+        uint32_t parent;            //!< Site of the scheduling event, or NO_SITE
+        const std::type_info* type; //!< Callback type
+        uint64_t events{0};         //!< Events executed
+        uint64_t cycles{0};         //!< Cycles spent in them
+    };
+
+    /// Identifies a site: the site of the scheduling event and the callback type
+    using SiteKey = std::pair<uint32_t, const std::type_info*>;
+
+    /// Hash of a SiteKey
+    struct SiteKeyHash
+    {
+        /**
+         * @param key the site key
+         * @return the hash
+         */
+        std::size_t operator()(const SiteKey& key) const
+        {
+            return std::hash<const void*>()(key.second) ^ (key.first * 0x9e3779b97f4a7c15ULL);
+        }
+    };
+
+    /// Wraps a scheduled event to time it
+    class ProfiledEvent;
+
+    void DoDispose() override;
+
+    /**
+     * Wrap an event, attributing it to the currently executing site.
+     *
+     * @param event the event, whose reference is taken over
+     * @return the wrapper, with one reference
+     */
+    EventImpl* Wrap(EventImpl* event);
+
+    /**
+     * Write the folded stacks to FoldedFile.
+     */
+    void WriteFolded() const;
+
+    /**
+     * @param type a callback type
+     * @return its readable name
+     */
+    static std::string GetName(const std::type_info& type);
+
+    /// Site of the events scheduled outside of any event
+    static constexpr uint32_t NO_SITE = UINT32_MAX;
+
+    Ptr<SimulatorImpl> m_impl; //!< Simulator doing the work
+    uint32_t m_topN;           //!< Rows of the report
+    std::string m_foldedFile;  //!< Folded stacks output, empty for none
+
+    std::vector<Site> m_sites;                                     //!< Every site seen
+    std::unordered_map<SiteKey, uint32_t, SiteKeyHash> m_siteKeys; //!< Index of each site
+    uint32_t m_current{NO_SITE};                                   //!< Site of the running event
+    uint64_t m_runCycles{0};                                       //!< Cycles spent in Run()
+    double m_runSeconds{0};                                        //!< Wall time spent in Run()
+    bool m_reported{false};                                        //!< Whether Report() ran
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_PROFILING_SIMULATOR_IMPL_H */
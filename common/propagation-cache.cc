@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "propagation-cache.h"
+
+#include "ns3/abort.h"
+#include "ns3/pointer.h"
+#include "ns3/yans-wifi-channel.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationDelayModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::CachedPropagationLossModel")
+                            .SetParent<PropagationLossModel>()
+                            .SetGroupName("Propagation")
+                            .AddConstructor<CachedPropagationLossModel>();
+    return tid;
+}
+
+void
+CachedPropagationLossModel::SetModel(Ptr<PropagationLossModel> model)
+{
+    m_model = model;
+    m_loss.Clear();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetModel() const
+{
+    return m_model;
+}
+
+uint64_t
+CachedPropagationLossModel::GetNHits() const
+{
+    return m_loss.GetNHits();
+}
+
+uint64_t
+CachedPropagationLossModel::GetNMisses() const
+{
+    return m_loss.GetNMisses();
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                          Ptr<MobilityModel> a,
+                                          Ptr<MobilityModel> b) const
+{
+    // Deterministic models subtract a loss that does not depend on the transmit power
+    return txPowerDbm - m_loss.Get(a, b, [&]() { return -m_model->CalcRxPower(0, a, b); });
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    return m_model ? m_model->AssignStreams(stream) : 0;
+}
+
+void
+CachedPropagationLossModel::DoDispose()
+{
+    m_loss.Clear();
+    m_model = nullptr;
+    PropagationLossModel::DoDispose();
+}
+
+TypeId
+CachedPropagationDelayModel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::CachedPropagationDelayModel")
+                            .SetParent<PropagationDelayModel>()
+                            .SetGroupName("Propagation")
+                            .AddConstructor<CachedPropagationDelayModel>();
+    return tid;
+}
+
+void
+CachedPropagationDelayModel::SetModel(Ptr<PropagationDelayModel> model)
+{
+    m_model = model;
+    m_delay.Clear();
+}
+
+Time
+CachedPropagationDelayModel::GetDelay(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+    return m_delay.Get(a, b, [&]() { return m_model->GetDelay(a, b); });
+}
+
+int64_t
+CachedPropagationDelayModel::DoAssignStreams(int64_t stream)
+{
+    return m_model ? m_model->AssignStreams(stream) : 0;
+}
+
+void
+CachedPropagationDelayModel::DoDispose()
+{
+    m_delay.Clear();
+    m_model = nullptr;
+    PropagationDelayModel::DoDispose();
+}
+
+Ptr<CachedPropagationLossModel>
+EnablePropagationCache(Ptr<YansWifiChannel> channel)
+{
+    PointerValue loss;
+    channel->GetAttribute("PropagationLossModel", loss);
+    PointerValue delay;
+    channel->GetAttribute("PropagationDelayModel", delay);
+    NS_ABORT_MSG_IF(!loss.Get<PropagationLossModel>() || !delay.Get<PropagationDelayModel>(),
+                    "The channel has no propagation loss or delay model");
+
+    Ptr<CachedPropagationLossModel> cachedLoss = CreateObject<CachedPropagationLossModel>();
+    cachedLoss->SetModel(loss.Get<PropagationLossModel>());
+    channel->SetPropagationLossModel(cachedLoss);
+
+    Ptr<CachedPropagationDelayModel> cachedDelay = CreateObject<CachedPropagationDelayModel>();
+    cachedDelay->SetModel(delay.Get<PropagationDelayModel>());
+    channel->SetPropagationDelayModel(cachedDelay);
+    return cachedLoss;
+}
+
+} // namespace ns3
@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_PROPAGATION_CACHE_H
+#define SCRATCH_PROPAGATION_CACHE_H
+
+// Pairwise propagation loss and delay tables for mostly static topologies.
+
+#include "ns3/callback.h"
+#include "ns3/mobility-model.h"
+#include "ns3/nstime.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/ptr.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class YansWifiChannel;
+
+/**
+ * Square table of a value computed for ordered pairs of mobility models,
+ * stored row-major in one contiguous array. The models are numbered in the
+ * order they are first seen and the table grows by doubling. Every entry
+ * involving a model is invalidated when the model fires its CourseChange
+ * trace, so only moving nodes pay for the computation again.
+ */
+template <typename T>
+class LinkTable
+{
+  public:
+    LinkTable() = default;
+
+    /**
+     * Disconnects from the mobility models.
+     */
+    ~LinkTable();
+
+    LinkTable(const LinkTable&) = delete;
+    LinkTable& operator=(const LinkTable&) = delete;
+
+    /**
+     * Get the value of a pair, computing it on a miss.
+     *
+     * @param a the first mobility model (e.g. the transmitter)
+     * @param b the second mobility model (e.g. the receiver)
+     * @param compute computes the value of the pair
+     * @return the value
+     */
+    template <typename F>
+    T Get(Ptr<MobilityModel> a, Ptr<MobilityModel> b, F compute);
+
+    /**
+     * Forget every entry and disconnect from the mobility models.
+     */
+    void Clear();
+
+    /**
+     * @return the number of lookups answered from the table
+     */
+    uint64_t GetNHits() const;
+
+    /**
+     * @return the number of values computed
+     */
+    uint64_t GetNMisses() const;
+
+  private:
+    /// An entry of the table
+    struct Entry
+    {
+        T value{};         //!< Cached value
+        bool valid{false}; //!< Whether value is up to date
+    };
+
+    /**
+     * Get the index of a mobility model, numbering and watching it if new.
+     *
+     * @param model the mobility model
+     * @return the index of its row and column
+     */
+    uint32_t GetIndex(const Ptr<MobilityModel>& model);
+
+    /**
+     * Invalidate the row and column of a model that changed course.
+     *
+     * @param model the mobility model
+     */
+    void CourseChanged(Ptr<const MobilityModel> model);
+
+    std::unordered_map<const MobilityModel*, uint32_t> m_indices; //!< Index of every model
+    std::vector<Ptr<MobilityModel>> m_models;                     //!< Watched models by index
+    std::vector<Entry> m_entries;                                 //!< Row-major entries
+    uint32_t m_capacity{0};                                       //!< Rows of m_entries
+    const MobilityModel* m_lastModel{nullptr};                    //!< Last first model of a pair
+    uint32_t m_lastIndex{0};                                      //!< Index of m_lastModel
+    uint64_t m_hits{0};                                           //!< Lookups served
+    uint64_t m_misses{0};                                         //!< Values computed
+};
+
+/**
+ * Propagation loss model that caches the loss of another (deterministic)
+ * loss model per pair of nodes. The wrapped model, including any model
+ * chained after it, must give the same loss for the same positions every
+ * time: Friis, log-distance or range models are fine, fading models are not.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CachedPropagationLossModel() = default;
+
+    /**
+     * @param model the loss model whose results are cached
+     */
+    void SetModel(Ptr<PropagationLossModel> model);
+
+    /**
+     * @return the loss model whose results are cached
+     */
+    Ptr<PropagationLossModel> GetModel() const;
+
+    /**
+     * @return the number of loss values served from the cache
+     */
+    uint64_t GetNHits() const;
+
+    /**
+     * @return the number of loss values computed by the wrapped model
+     */
+    uint64_t GetNMisses() const;
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+    void DoDispose() override;
+
+    Ptr<PropagationLossModel> m_model; //!< Wrapped model
+    mutable LinkTable<double> m_loss;  //!< Loss in dB per pair
+};
+
+/**
+ * Propagation delay model that caches the delay of another deterministic
+ * delay model per pair of nodes.
+ */
+class CachedPropagationDelayModel : public PropagationDelayModel
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CachedPropagationDelayModel() = default;
+
+    /**
+     * @param model the delay model whose results are cached
+     */
+    void SetModel(Ptr<PropagationDelayModel> model);
+
+    Time GetDelay(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const override;
+
+  private:
+    int64_t DoAssignStreams(int64_t stream) override;
+    void DoDispose() override;
+
+    Ptr<PropagationDelayModel> m_model; //!< Wrapped model
+    mutable LinkTable<Time> m_delay;    //!< Delay per pair
+};
+
+/**
+ * Replace the propagation loss and delay models of a channel by cached
+ * wrappers of themselves. Call it once the channel is created, before the
+ * simulation starts.
+ *
+ * @param channel the channel
+ * @return the cached loss model, e.g. to read its hit count
+ */
+Ptr<CachedPropagationLossModel> EnablePropagationCache(Ptr<YansWifiChannel> channel);
+
+template <typename T>
+LinkTable<T>::~LinkTable()
+{
+    Clear();
+}
+
+template <typename T>
+template <typename F>
+T
+LinkTable<T>::Get(Ptr<MobilityModel> a, Ptr<MobilityModel> b, F compute)
+{
+    // The transmitter is the same for the whole fan-out of a frame
+    if (PeekPointer(a) != m_lastModel)
+    {
+        m_lastIndex = GetIndex(a);
+        m_lastModel = PeekPointer(a);
+    }
+    uint32_t i = m_lastIndex;
+    uint32_t j = GetIndex(b);
+    Entry& entry = m_entries[static_cast<std::size_t>(i) * m_capacity + j];
+    if (entry.valid)
+    {
+        ++m_hits;
+        return entry.value;
+    }
+    ++m_misses;
+    entry.value = compute();
+    entry.valid = true;
+    return entry.value;
+}
+
+template <typename T>
+void
+LinkTable<T>::Clear()
+{
+    for (auto& model : m_models)
+    {
+        model->TraceDisconnectWithoutContext("CourseChange",
+                                             MakeCallback(&LinkTable<T>::CourseChanged, this));
+    }
+    m_indices.clear();
+    m_models.clear();
+    m_entries.clear();
+    m_capacity = 0;
+    m_lastModel = nullptr;
+}
+
+template <typename T>
+uint64_t
+LinkTable<T>::GetNHits() const
+{
+    return m_hits;
+}
+
+template <typename T>
+uint64_t
+LinkTable<T>::GetNMisses() const
+{
+    return m_misses;
+}
+
+template <typename T>
+uint32_t
+LinkTable<T>::GetIndex(const Ptr<MobilityModel>& model)
+{
+    auto [it, inserted] = m_indices.emplace(PeekPointer(model), m_models.size());
+    if (inserted)
+    {
+        m_models.push_back(model);
+        model->TraceConnectWithoutContext("CourseChange",
+                                          MakeCallback(&LinkTable<T>::CourseChanged, this));
+        if (m_models.size() > m_capacity)
+        {
+            uint32_t capacity = std::max<uint32_t>(8, 2 * m_capacity);
+            std::vector<Entry> entries(static_cast<std::size_t>(capacity) * capacity);
+            for (uint32_t row = 0; row < m_capacity; ++row)
+            {
+                std::copy_n(m_entries.begin() + static_cast<std::size_t>(row) * m_capacity,
+                            m_capacity,
+                            entries.begin() + static_cast<std::size_t>(row) * capacity);
+            }
+            m_entries.swap(entries);
+            m_capacity = capacity;
+        }
+    }
+    return it->second;
+}
+
+template <typename T>
+void
+LinkTable<T>::CourseChanged(Ptr<const MobilityModel> model)
+{
+    auto it = m_indices.find(PeekPointer(model));
+    if (it == m_indices.end())
+    {
+        return;
+    }
+    std::size_t index = it->second;
+    for (std::size_t other = 0; other < m_models.size(); ++other)
+    {
+        m_entries[index * m_capacity + other].valid = false;
+        m_entries[other * m_capacity + index].valid = false;
+    }
+}
+
+} // namespace ns3
+
+#endif /* SCRATCH_PROPAGATION_CACHE_H */
@@ -0,0 +1,296 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "pruned-wifi-channel.h"
+
+#include "propagation-cache.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/yans-wifi-phy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("YansWifiChannelPruner");
+
+NS_OBJECT_ENSURE_REGISTERED(YansWifiChannelPruner);
+
+TypeId
+YansWifiChannelPruner::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::YansWifiChannelPruner")
+            .SetParent<Object>()
+            .SetGroupName("Wifi")
+            .AddConstructor<YansWifiChannelPruner>()
+            .AddAttribute("RxPowerFloor",
+                          "Weakest received power (dBm) delivered to a receiver",
+                          DoubleValue(-110),
+                          MakeDoubleAccessor(&YansWifiChannelPruner::m_rxPowerFloor),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("CellSize",
+                          "Width (m) of the cells of the station grid",
+                          DoubleValue(100),
+                          MakeDoubleAccessor(&YansWifiChannelPruner::m_cellSize),
+                          MakeDoubleChecker<double>(1));
+    return tid;
+}
+
+void
+YansWifiChannelPruner::Install(Ptr<YansWifiChannel> channel)
+{
+    NS_ABORT_MSG_UNLESS(m_stations.empty(), "The pruner is already installed");
+
+    PointerValue loss;
+    channel->GetAttribute("PropagationLossModel", loss);
+    m_loss = loss.Get<PropagationLossModel>();
+    PointerValue delay;
+    channel->GetAttribute("PropagationDelayModel", delay);
+    m_delay = delay.Get<PropagationDelayModel>();
+    NS_ABORT_MSG_IF(!m_loss || !m_delay, "The channel has no propagation loss or delay model");
+
+    // The range is only known for a Friis model at the head of the chain
+    Ptr<PropagationLossModel> model = m_loss;
+    if (auto cached = DynamicCast<CachedPropagationLossModel>(model))
+    {
+        model = cached->GetModel();
+    }
+    auto friis = DynamicCast<FriisPropagationLossModel>(model);
+    m_wavelength = friis ? 299792458.0 / friis->GetFrequency() : 0;
+    if (!friis)
+    {
+        NS_LOG_WARN("The loss model is not Friis, no receiver is pruned");
+    }
+
+    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    {
+        auto device = DynamicCast<WifiNetDevice>(channel->GetDevice(i));
+        NS_ABORT_MSG_IF(!device, "Every PHY on a pruned channel needs a device");
+        Ptr<YansWifiPhy> phy;
+        for (const auto& candidate : device->GetPhys())
+        {
+            if (candidate->GetChannel() == channel)
+            {
+                phy = DynamicCast<YansWifiPhy>(candidate);
+            }
+        }
+        NS_ABORT_MSG_IF(!phy || !phy->GetMobility(), "PHY " << i << " has no mobility model");
+
+        Station station;
+        station.phy = phy;
+        station.mobility = phy->GetMobility();
+        Vector position = station.mobility->GetPosition();
+        station.cell = GetCell(position.x, position.y);
+        // YansWifiPhy::StartTx() sends at the power of the PPDU plus the transmit gain
+        station.range = GetRange(phy->GetTxPowerEnd() + phy->GetTxGain());
+        m_cells[station.cell].push_back(m_stations.size());
+        m_byMobility[PeekPointer(station.mobility)] = m_stations.size();
+        station.mobility->TraceConnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&YansWifiChannelPruner::CourseChanged, this));
+        m_stations.push_back(station);
+    }
+    for (uint32_t i = 0; i < m_stations.size(); ++i)
+    {
+        m_stations[i].receivers = FindReceivers(i);
+        BuildView(i);
+    }
+    NS_LOG_DEBUG(m_stations.size() << " stations in " << m_cells.size() << " cells, "
+                                   << GetNPrunedLinks() << " links pruned");
+}
+
+uint64_t
+YansWifiChannelPruner::GetNPrunedLinks() const
+{
+    uint64_t pruned = 0;
+    for (const auto& station : m_stations)
+    {
+        pruned += m_stations.size() - 1 - station.receivers.size();
+    }
+    return pruned;
+}
+
+void
+YansWifiChannelPruner::DoDispose()
+{
+    for (const auto& station : m_stations)
+    {
+        station.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&YansWifiChannelPruner::CourseChanged, this));
+    }
+    m_stations.clear();
+    m_cells.clear();
+    m_byMobility.clear();
+    m_loss = nullptr;
+    m_delay = nullptr;
+    Object::DoDispose();
+}
+
+std::vector<uint32_t>
+YansWifiChannelPruner::FindReceivers(uint32_t sender) const
+{
+    std::vector<uint32_t> candidates;
+    double reach = std::ceil(m_stations[sender].range / m_cellSize);
+    if (!(reach < m_cells.size()) || (2 * reach + 1) * (2 * reach + 1) >= m_cells.size())
+    {
+        // Scanning the cells would cost more than trying every station
+        for (uint32_t i = 0; i < m_stations.size(); ++i)
+        {
+            candidates.push_back(i);
+        }
+    }
+    else
+    {
+        Vector position = m_stations[sender].mobility->GetPosition();
+        auto cells = static_cast<int64_t>(reach);
+        auto column = static_cast<int64_t>(std::floor(position.x / m_cellSize));
+        auto row = static_cast<int64_t>(std::floor(position.y / m_cellSize));
+        for (int64_t c = column - cells; c <= column + cells; ++c)
+        {
+            for (int64_t r = row - cells; r <= row + cells; ++r)
+            {
+                auto cell = m_cells.find(GetCellKey(c, r));
+                if (cell != m_cells.end())
+                {
+                    candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+                }
+            }
+        }
+        // Same delivery order as the channel, hence the same event order
+        std::sort(candidates.begin(), candidates.end());
+    }
+
+    std::vector<uint32_t> receivers;
+    for (uint32_t i : candidates)
+    {
+        if (i != sender && InRange(sender, i))
+        {
+            receivers.push_back(i);
+        }
+    }
+    return receivers;
+}
+
+bool
+YansWifiChannelPruner::InRange(uint32_t sender, uint32_t receiver) const
+{
+    return m_stations[sender].mobility->GetDistanceFrom(m_stations[receiver].mobility) <=
+           m_stations[sender].range;
+}
+
+void
+YansWifiChannelPruner::BuildView(uint32_t sender)
+{
+    Station& station = m_stations[sender];
+    Ptr<YansWifiChannel> view = CreateObject<YansWifiChannel>();
+    view->SetPropagationLossModel(m_loss);
+    view->SetPropagationDelayModel(m_delay);
+    for (uint32_t i : station.receivers)
+    {
+        view->Add(m_stations[i].phy);
+    }
+    // Adds the sender to the view too, which Send() skips
+    station.phy->SetChannel(view);
+}
+
+uint64_t
+YansWifiChannelPruner::GetCell(double x, double y) const
+{
+    return GetCellKey(static_cast<int64_t>(std::floor(x / m_cellSize)),
+                      static_cast<int64_t>(std::floor(y / m_cellSize)));
+}
+
+uint64_t
+YansWifiChannelPruner::GetCellKey(int64_t column, int64_t row)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) |
+           static_cast<uint32_t>(row);
+}
+
+void
+YansWifiChannelPruner::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    auto it = m_byMobility.find(PeekPointer(mobility));
+    if (it == m_byMobility.end())
+    {
+        return;
+    }
+    uint32_t moved = it->second;
+    Station& station = m_stations[moved];
+    Vector position = mobility->GetPosition();
+    uint64_t cell = GetCell(position.x, position.y);
+    if (cell != station.cell)
+    {
+        auto& members = m_cells[station.cell];
+        members.erase(std::find(members.begin(), members.end(), moved));
+        if (members.empty())
+        {
+            m_cells.erase(station.cell);
+        }
+        m_cells[cell].push_back(moved);
+        station.cell = cell;
+    }
+
+    // The receivers of the moved station, then the views it enters or leaves
+    std::vector<uint32_t> receivers = FindReceivers(moved);
+    if (receivers != station.receivers)
+    {
+        station.receivers = std::move(receivers);
+        BuildView(moved);
+    }
+    for (uint32_t i = 0; i < m_stations.size(); ++i)
+    {
+        if (i == moved)
+        {
+            continue;
+        }
+        auto& members = m_stations[i].receivers;
+        auto position = std::lower_bound(members.begin(), members.end(), moved);
+        bool member = position != members.end() && *position == moved;
+        if (member != InRange(i, moved))
+        {
+            if (member)
+            {
+                members.erase(position);
+            }
+            else
+            {
+                members.insert(position, moved);
+            }
+            BuildView(i);
+        }
+    }
+}
+
+double
+YansWifiChannelPruner::GetRange(double txPowerDbm) const
+{
+    if (m_wavelength == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    // Free space: Prx = Ptx - 20 log10(4 pi d / lambda); the minimum and system
+    // losses of the model only make the actual range shorter
+    return m_wavelength / (4 * M_PI) * std::pow(10.0, (txPowerDbm - m_rxPowerFloor) / 20);
+}
+
+Ptr<YansWifiChannelPruner>
+PruneChannel(Ptr<YansWifiChannel> channel, double rxPowerFloor)
+{
+    Ptr<YansWifiChannelPruner> pruner = CreateObject<YansWifiChannelPruner>();
+    pruner->SetAttribute("RxPowerFloor", DoubleValue(rxPowerFloor));
+    pruner->Install(channel);
+    return pruner;
+}
+
+} // namespace ns3
@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_PRUNED_WIFI_CHANNEL_H
+#define SCRATCH_PRUNED_WIFI_CHANNEL_H
+
+// Per-transmitter views of a Yans Wi-Fi channel that only hold the receivers
+// in range.
+
+#include "ns3/mobility-model.h"
+#include "ns3/object.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/yans-wifi-channel.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class YansWifiPhy;
+
+/**
+ * Prunes the receivers of a YansWifiChannel without changing the channel.
+ *
+ * YansWifiChannel::Send() is not virtual and delivers every frame to every
+ * PHY of the channel's list, so the pruning is done through that list: each
+ * PHY is moved (with YansWifiPhy::SetChannel()) to its own YansWifiChannel,
+ * a view sharing the propagation models of the channel whose list only holds
+ * the PHYs in range of it, in the order of the channel. A PHY is in range if
+ * it is within the distance at which the Friis loss of the channel drops the
+ * maximum transmit power of the sender to RxPowerFloor. The views are found
+ * through a uniform grid of the x-y plane.
+ *
+ * The range is computed from the frequency of the FriisPropagationLossModel
+ * of the channel, unwrapped from a CachedPropagationLossModel if needed;
+ * with any other loss model nothing is pruned. Each view delivers to its
+ * receivers in channel order, so as long as RxPowerFloor is below the
+ * receive sensitivity minus the receive gain of the PHYs (-101 dBm and 0 dB
+ * by default), the simulation is the same as with the full channel: the
+ * frames that are not delivered would have been dropped on arrival.
+ *
+ * The views follow the CourseChange trace of the PHYs, so they stay exact
+ * for nodes that stand still or jump; nodes moving at a constant velocity
+ * between course changes are not supported.
+ */
+class YansWifiChannelPruner : public Object
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    YansWifiChannelPruner() = default;
+
+    /**
+     * Give every PHY of a channel its pruned view. Call it once every device
+     * is installed on the channel and has its mobility model, and after
+     * EnablePropagationCache() if the cache is used.
+     *
+     * @param channel the channel
+     */
+    void Install(Ptr<YansWifiChannel> channel);
+
+    /**
+     * @return the number of transmitter and receiver pairs currently pruned
+     */
+    uint64_t GetNPrunedLinks() const;
+
+  private:
+    void DoDispose() override;
+
+    /// A PHY of the channel, both transmitter and receiver
+    struct Station
+    {
+        Ptr<YansWifiPhy> phy;            //!< PHY
+        Ptr<MobilityModel> mobility;     //!< Mobility model of the PHY
+        uint64_t cell;                   //!< Key of the grid cell holding the PHY
+        double range;                    //!< Reach of its transmissions in meters
+        std::vector<uint32_t> receivers; //!< Stations in range, in channel order
+    };
+
+    /**
+     * @param sender the index of the transmitting station
+     * @return the indices of the other stations in range, in channel order
+     */
+    std::vector<uint32_t> FindReceivers(uint32_t sender) const;
+
+    /**
+     * @param sender the index of the transmitting station
+     * @param receiver the index of the receiving station
+     * @return whether the receiver is in range of the sender
+     */
+    bool InRange(uint32_t sender, uint32_t receiver) const;
+
+    /**
+     * Attach a station to a new view holding its current receivers.
+     *
+     * @param sender the index of the station
+     */
+    void BuildView(uint32_t sender);
+
+    /**
+     * @param x the x coordinate in meters
+     * @param y the y coordinate in meters
+     * @return the key of the grid cell holding the point
+     */
+    uint64_t GetCell(double x, double y) const;
+
+    /**
+     * @param column the column of the cell
+     * @param row the row of the cell
+     * @return the key of the cell
+     */
+    static uint64_t GetCellKey(int64_t column, int64_t row);
+
+    /**
+     * Move a station to its current cell after a course change and update
+     * the views it enters or leaves.
+     *
+     * @param mobility the mobility model that changed course
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    /**
+     * @param txPowerDbm the transmit power
+     * @return the distance beyond which the received power is below the floor
+     */
+    double GetRange(double txPowerDbm) const;
+
+    /// Indices of the stations in each grid cell
+    using CellMap = std::unordered_map<uint64_t, std::vector<uint32_t>>;
+    /// Index of the station of each mobility model
+    using MobilityMap = std::unordered_map<const MobilityModel*, uint32_t>;
+
+    double m_rxPowerFloor; //!< Weakest power delivered in dBm
+    double m_cellSize;     //!< Width of a grid cell in meters
+
+    Ptr<PropagationLossModel> m_loss;   //!< Loss model of the channel
+    Ptr<PropagationDelayModel> m_delay; //!< Delay model of the channel
+    double m_wavelength{0};             //!< Friis wavelength in meters, 0 if not Friis
+    std::vector<Station> m_stations;    //!< Stations in channel order
+    CellMap m_cells;                    //!< Stations per grid cell
+    MobilityMap m_byMobility;           //!< Station of each mobility model
+};
+
+/**
+ * Prune the receivers of a channel.
+ *
+ * @param channel the channel, with its devices and their mobility models installed
+ * @param rxPowerFloor the weakest power delivered in dBm
+ * @return the pruner, which must live as long as the channel
+ */
+Ptr<YansWifiChannelPruner> PruneChannel(Ptr<YansWifiChannel> channel, double rxPowerFloor);
+
+} // namespace ns3
+
+#endif /* SCRATCH_PRUNED_WIFI_CHANNEL_H */
@@ -0,0 +1,227 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "radix-heap-scheduler.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RadixHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(RadixHeapScheduler);
+
+namespace
+{
+
+/**
+ * @param a an event
+ * @param b another event
+ * @return whether @p a was scheduled before @p b
+ */
+bool
+ByUid(const Scheduler::Event& a, const Scheduler::Event& b)
+{
+    return a.key.m_uid < b.key.m_uid;
+}
+
+} // namespace
+
+TypeId
+RadixHeapScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::RadixHeapScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<RadixHeapScheduler>();
+    return tid;
+}
+
+void
+RadixHeapScheduler::Insert(const Event& ev)
+{
+    if (ev.key.m_ts < m_last)
+    {
+        Rebase(ev.key.m_ts);
+    }
+    auto& first = m_buckets[0];
+    if (ev.key.m_ts == m_last && first.size() > m_head && ev.key.m_uid < first.back().key.m_uid)
+    {
+        // Only reached when the uids are not scheduled in order
+        first.insert(std::upper_bound(first.begin() + m_head, first.end(), ev, ByUid), ev);
+    }
+    else
+    {
+        Place(ev);
+    }
+    ++m_size;
+}
+
+bool
+RadixHeapScheduler::IsEmpty() const
+{
+    return m_size == 0;
+}
+
+Scheduler::Event
+RadixHeapScheduler::PeekNext() const
+{
+    NS_ASSERT(!IsEmpty());
+    Refill();
+    return m_buckets[0][m_head];
+}
+
+Scheduler::Event
+RadixHeapScheduler::RemoveNext()
+{
+    NS_ASSERT(!IsEmpty());
+    Refill();
+    auto& first = m_buckets[0];
+    Event ev = first[m_head];
+    if (++m_head == first.size())
+    {
+        first.clear();
+        m_head = 0;
+    }
+    --m_size;
+    return ev;
+}
+
+void
+RadixHeapScheduler::Remove(const Event& ev)
+{
+    uint32_t bucket = GetBucket(ev.key.m_ts);
+    auto& events = m_buckets[bucket];
+    auto begin = events.begin() + (bucket == 0 ? m_head : 0);
+    auto it = std::find_if(begin, events.end(), [&ev](const Event& e) {
+        return e.key.m_uid == ev.key.m_uid;
+    });
+    NS_ASSERT_MSG(it != events.end(), "Event " << ev.key.m_uid << " is not scheduled");
+    if (bucket == 0)
+    {
+        // Keeps the uid order
+        events.erase(it);
+    }
+    else
+    {
+        *it = events.back();
+        events.pop_back();
+    }
+    if (events.size() == (bucket == 0 ? m_head : 0))
+    {
+        events.clear();
+        if (bucket == 0)
+        {
+            m_head = 0;
+        }
+        else
+        {
+            m_nonEmpty &= ~(uint64_t{1} << (bucket - 1));
+        }
+    }
+    --m_size;
+}
+
+uint32_t
+RadixHeapScheduler::GetBucket(uint64_t ts) const
+{
+    return ts == m_last ? 0 : 64 - __builtin_clzll(ts ^ m_last);
+}
+
+void
+RadixHeapScheduler::Place(const Event& ev) const
+{
+    uint32_t bucket = GetBucket(ev.key.m_ts);
+    m_buckets[bucket].push_back(ev);
+    if (bucket > 0)
+    {
+        m_nonEmpty |= uint64_t{1} << (bucket - 1);
+    }
+}
+
+void
+RadixHeapScheduler::Refill() const
+{
+    if (m_head < m_buckets[0].size() || m_nonEmpty == 0)
+    {
+        return;
+    }
+    uint32_t bucket = __builtin_ctzll(m_nonEmpty) + 1;
+    m_nonEmpty &= ~(uint64_t{1} << (bucket - 1));
+    auto& events = m_buckets[bucket];
+    uint64_t earliest = std::numeric_limits<uint64_t>::max();
+    for (const auto& ev : events)
+    {
+        earliest = std::min(earliest, ev.key.m_ts);
+    }
+    // Every event of the bucket moves to a lower one
+    m_last = earliest;
+    for (const auto& ev : events)
+    {
+        Place(ev);
+    }
+    events.clear();
+    SortFirstBucket();
+}
+
+void
+RadixHeapScheduler::Rebase(uint64_t ts)
+{
+    NS_LOG_FUNCTION(this << ts);
+    std::vector<Event> events(m_buckets[0].begin() + m_head, m_buckets[0].end());
+    m_buckets[0].clear();
+    m_head = 0;
+    for (uint32_t bucket = 1; bucket < BUCKETS; ++bucket)
+    {
+        events.insert(events.end(), m_buckets[bucket].begin(), m_buckets[bucket].end());
+        m_buckets[bucket].clear();
+    }
+    m_nonEmpty = 0;
+    m_last = ts;
+    for (const auto& ev : events)
+    {
+        Place(ev);
+    }
+    SortFirstBucket();
+}
+
+void
+RadixHeapScheduler::SortFirstBucket() const
+{
+    std::sort(m_buckets[0].begin() + m_head, m_buckets[0].end(), ByUid);
+}
+
+std::string
+GetSchedulerTypeName(const std::string& name)
+{
+    static const std::map<std::string, std::string> SCHEDULERS = {
+        {"map", "ns3::MapScheduler"},
+        {"heap", "ns3::HeapScheduler"},
+        {"list", "ns3::ListScheduler"},
+        {"calendar", "ns3::CalendarScheduler"},
+        {"priority", "ns3::PriorityQueueScheduler"},
+        {"radix", RadixHeapScheduler::GetTypeId().GetName()},
+    };
+    auto it = SCHEDULERS.find(name);
+    if (it != SCHEDULERS.end())
+    {
+        return it->second;
+    }
+    TypeId tid;
+    NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe(name, &tid) &&
+                            tid.IsChildOf(Scheduler::GetTypeId()),
+                        "Unknown scheduler '" << name
+                                              << "', use map, heap, list, calendar, priority, "
+                                                 "radix or the TypeId of a Scheduler");
+    return name;
+}
+
+} // namespace ns3
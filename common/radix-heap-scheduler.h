@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_RADIX_HEAP_SCHEDULER_H
+#define SCRATCH_RADIX_HEAP_SCHEDULER_H
+
+// Event scheduler based on a radix heap, and the choice of scheduler.
+
+#include "ns3/scheduler.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Event scheduler keeping the events in a radix heap of 65 buckets.
+ *
+ * An event goes to the bucket numbered after the highest bit in which its
+ * timestamp differs from the timestamp of the last event removed (bucket 0
+ * when equal). Insertion is an append to a vector; when bucket 0 runs out,
+ * the lowest non-empty bucket is split into the lower ones around its
+ * earliest timestamp, so that every event is moved at most 64 times over its
+ * life, with sequential accesses only. Events of equal timestamps leave in
+ * the order of their uid, as in the other schedulers.
+ *
+ * The heap relies on the simulator never scheduling before the current
+ * time. An event earlier than the last one peeked at (as real time
+ * simulators do) is still accepted, by redistributing every event.
+ */
+class RadixHeapScheduler : public Scheduler
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    RadixHeapScheduler() = default;
+    ~RadixHeapScheduler() override = default;
+
+    // Inherited from Scheduler
+    void Insert(const Event& ev) override;
+    bool IsEmpty() const override;
+    Event PeekNext() const override;
+    Event RemoveNext() override;
+    void Remove(const Event& ev) override;
+
+  private:
+    /// Number of buckets: one for the last timestamp, one per bit of the others
+    static constexpr uint32_t BUCKETS = 65;
+
+    /**
+     * @param ts a timestamp
+     * @return the bucket of the timestamp
+     */
+    uint32_t GetBucket(uint64_t ts) const;
+
+    /**
+     * Append an event to its bucket, regardless of the uid order of bucket 0.
+     *
+     * @param ev the event
+     */
+    void Place(const Event& ev) const;
+
+    /**
+     * Split the lowest non-empty bucket when bucket 0 is empty.
+     */
+    void Refill() const;
+
+    /**
+     * Redistribute every event around an earlier timestamp.
+     *
+     * @param ts the new reference timestamp
+     */
+    void Rebase(uint64_t ts);
+
+    /**
+     * Sort the pending events of bucket 0 by uid.
+     */
+    void SortFirstBucket() const;
+
+    // Splitting a bucket changes the layout but not the content, hence
+    // PeekNext() can do it
+    mutable std::array<std::vector<Event>, BUCKETS> m_buckets; //!< Events of each bucket
+    mutable uint64_t m_nonEmpty{0}; //!< Bit i - 1 set if bucket i > 0 has events
+    mutable std::size_t m_head{0};  //!< First pending event of bucket 0
+    mutable uint64_t m_last{0};     //!< Reference timestamp of the buckets
+    std::size_t m_size{0};          //!< Number of events
+};
+
+/**
+ * Get the TypeId name of an event scheduler, for the SchedulerType global
+ * value.
+ *
+ * @param name map, heap, list, calendar, priority (the priority queue
+ *        scheduler), radix (RadixHeapScheduler), or a TypeId name
+ * @return the TypeId name of the scheduler
+ */
+std::string GetSchedulerTypeName(const std::string& name);
+
+} // namespace ns3
+
+#endif /* SCRATCH_RADIX_HEAP_SCHEDULER_H */
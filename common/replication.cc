@@ -0,0 +1,234 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "replication.h"
+
+#include "ns3/abort.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// A replication being simulated by a child
+struct RunningReplication
+{
+    pid_t pid;                 //!< Process id
+    int fd;                    //!< Read end of the result pipe
+    uint32_t index;            //!< Index of the replication
+    std::vector<char> message; //!< Bytes received so far
+};
+
+/**
+ * Write a buffer to a file descriptor, retrying on partial writes.
+ *
+ * @param fd the file descriptor
+ * @param data the data
+ * @param size the size of the data
+ */
+void
+WriteAll(int fd, const void* data, std::size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        ssize_t n = write(fd, bytes, size);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return;
+        }
+        bytes += n;
+        size -= n;
+    }
+}
+
+/**
+ * Body of a child: simulate one replication and report the collected values.
+ *
+ * Message format: the number of values as a uint32_t, then the values as doubles.
+ *
+ * @param fd write end of the result pipe
+ * @param run the RngRun of the replication
+ * @param reseed re-assigns the random streams
+ * @param collect returns the values to report
+ */
+[[noreturn]] void
+RunChild(int fd,
+         uint64_t run,
+         const std::function<void()>& reseed,
+         const std::function<std::vector<double>()>& collect)
+{
+    RngSeedManager::SetRun(run);
+    reseed();
+    Simulator::Run();
+    std::vector<double> values = collect();
+    auto count = static_cast<uint32_t>(values.size());
+    WriteAll(fd, &count, sizeof(count));
+    WriteAll(fd, values.data(), values.size() * sizeof(double));
+    close(fd);
+    // Skip Simulator::Destroy() and static destructors: the parent owns them
+    _exit(0);
+}
+
+/**
+ * Decode the message of a child.
+ *
+ * @param message the bytes received from the child
+ * @param result receives the values
+ */
+void
+Decode(const std::vector<char>& message, ReplicationResult& result)
+{
+    uint32_t count = 0;
+    if (message.size() < sizeof(count))
+    {
+        return;
+    }
+    std::memcpy(&count, message.data(), sizeof(count));
+    if (message.size() != sizeof(count) + count * sizeof(double))
+    {
+        return;
+    }
+    result.values.resize(count);
+    std::memcpy(result.values.data(), message.data() + sizeof(count), count * sizeof(double));
+    result.ok = true;
+}
+
+} // namespace
+
+std::vector<ReplicationResult>
+RunForkedReplications(uint32_t replications,
+                      uint64_t firstRun,
+                      unsigned jobs,
+                      const std::function<void()>& reseed,
+                      const std::function<std::vector<double>()>& collect)
+{
+    if (jobs == 0)
+    {
+        jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // Buffered output would otherwise be written once by every child
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    std::vector<ReplicationResult> results(replications);
+    std::vector<RunningReplication> running;
+    std::vector<pollfd> pollFds;
+    char buffer[4096];
+    uint32_t next = 0;
+
+    while (next < replications || !running.empty())
+    {
+        while (running.size() < jobs && next < replications)
+        {
+            results[next].run = firstRun + next;
+            int fds[2];
+            NS_ABORT_MSG_IF(pipe2(fds, O_CLOEXEC) != 0,
+                            "pipe() failed: " << std::strerror(errno));
+            pid_t pid = fork();
+            NS_ABORT_MSG_IF(pid < 0, "fork() failed: " << std::strerror(errno));
+            if (pid == 0)
+            {
+                close(fds[0]);
+                for (const auto& other : running)
+                {
+                    close(other.fd);
+                }
+                RunChild(fds[1], results[next].run, reseed, collect);
+            }
+            close(fds[1]);
+            running.push_back({pid, fds[0], next, {}});
+            ++next;
+        }
+
+        pollFds.clear();
+        for (const auto& child : running)
+        {
+            pollFds.push_back({child.fd, POLLIN, 0});
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            NS_ABORT_MSG_IF(errno != EINTR, "poll() failed: " << std::strerror(errno));
+            continue;
+        }
+
+        for (std::size_t i = running.size(); i-- > 0;)
+        {
+            if (pollFds[i].revents == 0)
+            {
+                continue;
+            }
+            auto& child = running[i];
+            ssize_t n = read(child.fd, buffer, sizeof(buffer));
+            if (n > 0)
+            {
+                child.message.insert(child.message.end(), buffer, buffer + n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            close(child.fd);
+            int status = 0;
+            while (waitpid(child.pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            {
+                Decode(child.message, results[child.index]);
+            }
+            running.erase(running.begin() + i);
+        }
+    }
+    return results;
+}
+
+std::vector<SampleSummary>
+SummarizeReplications(const std::vector<ReplicationResult>& results, double confidence)
+{
+    std::vector<std::vector<double>> samples;
+    for (const auto& result : results)
+    {
+        if (!result.ok)
+        {
+            continue;
+        }
+        samples.resize(std::max(samples.size(), result.values.size()));
+        for (std::size_t i = 0; i < result.values.size(); ++i)
+        {
+            samples[i].push_back(result.values[i]);
+        }
+    }
+    std::vector<SampleSummary> summaries;
+    summaries.reserve(samples.size());
+    for (const auto& values : samples)
+    {
+        summaries.push_back(Summarize(values, confidence));
+    }
+    return summaries;
+}
+
+} // namespace ns3
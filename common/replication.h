@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_REPLICATION_H
+#define SCRATCH_REPLICATION_H
+
+// Fork-after-setup replications: the scenario is built once and every
+// replication is simulated by a copy-on-write child of the setup process.
+
+#include "statistics.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Values reported by one replication.
+ */
+struct ReplicationResult
+{
+    uint64_t run{0};            //!< RngRun used by the replication
+    bool ok{false};             //!< Whether the child reported its values
+    std::vector<double> values; //!< Values returned by the collect callback
+};
+
+/**
+ * Simulate an already built scenario several times, each time in a forked child.
+ *
+ * Replication i runs in a child that calls RngSeedManager::SetRun(firstRun + i),
+ * then @p reseed, Simulator::Run() and @p collect. The collected values are
+ * streamed back to this process through a pipe and the child exits without
+ * tearing the simulation down.
+ *
+ * Random variables created during the setup keep the run number they were
+ * created with, so @p reseed must re-assign their streams (e.g. through the
+ * AssignStreams() methods of the helpers); anything created while the
+ * simulation runs picks up the new run number by itself.
+ *
+ * Must be called after the scenario is built and before Simulator::Run();
+ * the calling process does not simulate. Pending output on the standard
+ * streams is flushed before forking.
+ *
+ * @param replications number of replications
+ * @param firstRun RngRun of the first replication
+ * @param jobs maximum number of concurrent children (0 selects the number of cores)
+ * @param reseed re-assigns the random streams of the scenario, run in each child
+ * @param collect returns the values to report, run in each child after the simulation
+ * @return the results, indexed by replication
+ */
+std::vector<ReplicationResult> RunForkedReplications(
+    uint32_t replications,
+    uint64_t firstRun,
+    unsigned jobs,
+    const std::function<void()>& reseed,
+    const std::function<std::vector<double>()>& collect);
+
+/**
+ * Summarize each reported value over the successful replications.
+ *
+ * @param results the results of RunForkedReplications()
+ * @param confidence the confidence level of the intervals
+ * @return one summary per value index
+ */
+std::vector<SampleSummary> SummarizeReplications(const std::vector<ReplicationResult>& results,
+                                                 double confidence = 0.95);
+
+} // namespace ns3
+
+#endif /* SCRATCH_REPLICATION_H */
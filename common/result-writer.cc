@@ -0,0 +1,213 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "result-writer.h"
+
+#include <cinttypes>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * @param type a column type
+ * @return the name of the type in the schema header
+ */
+const char*
+GetTypeName(ResultWriter::ColumnType type)
+{
+    switch (type)
+    {
+    case ResultWriter::ColumnType::INT64:
+        return "int64";
+    case ResultWriter::ColumnType::UINT64:
+        return "uint64";
+    case ResultWriter::ColumnType::DOUBLE:
+        return "double";
+    }
+    return "";
+}
+
+} // namespace
+
+ResultWriter::ResultWriter(const std::string& filename, Format format, std::size_t bufferSize)
+    : m_filename(filename),
+      m_format(format)
+{
+    m_file = std::fopen(filename.c_str(), format == Format::CSV ? "w" : "wb");
+    NS_ABORT_MSG_IF(!m_file, "Cannot open result file " << filename);
+    m_rows.resize(bufferSize);
+}
+
+ResultWriter::~ResultWriter()
+{
+    Close();
+}
+
+ResultWriter::Format
+ResultWriter::GetFormat(const std::string& name)
+{
+    if (name == "csv")
+    {
+        return Format::CSV;
+    }
+    if (name == "binary")
+    {
+        return Format::BINARY;
+    }
+    NS_ABORT_MSG("Unknown result format '" << name << "', use csv or binary");
+    return Format::CSV;
+}
+
+void
+ResultWriter::AddMetadata(const std::string& key, const std::string& value)
+{
+    NS_ABORT_MSG_IF(m_headerWritten, "Metadata must be added before the first row");
+    NS_ABORT_MSG_IF(value.find('\n') != std::string::npos, "Metadata values are single lines");
+    m_metadata.emplace_back(key, value);
+}
+
+void
+ResultWriter::AddColumn(const std::string& name, ColumnType type)
+{
+    NS_ABORT_MSG_IF(m_headerWritten, "Columns must be added before the first row");
+    m_columns.push_back({name, type});
+    m_offsets.push_back(m_rowSize);
+    m_rowSize += 8;
+}
+
+void
+ResultWriter::WriteHeader()
+{
+    NS_ABORT_MSG_IF(!m_file, "Result file " << m_filename << " is closed");
+    NS_ABORT_MSG_IF(m_columns.empty(), "Result file " << m_filename << " has no columns");
+    NS_ABORT_MSG_IF(m_rows.size() < m_rowSize, "Result buffer smaller than one row");
+    m_headerWritten = true;
+
+    std::string body;
+    for (const auto& [key, value] : m_metadata)
+    {
+        body += "# " + key + "=" + value + "\n";
+    }
+    body += "# columns=";
+    for (std::size_t i = 0; i < m_columns.size(); ++i)
+    {
+        body += (i ? "," : "") + m_columns[i].name + ":" + GetTypeName(m_columns[i].type);
+    }
+    body += "\n";
+
+    std::string header;
+    if (m_format == Format::CSV)
+    {
+        header = "# ns3-results 1\n" + body;
+        for (std::size_t i = 0; i < m_columns.size(); ++i)
+        {
+            header += (i ? "," : "") + m_columns[i].name;
+        }
+        header += "\n";
+    }
+    else
+    {
+        // The first line holds the total header size, which includes its own digits
+        std::string first = "# ns3-results 1 ";
+        std::size_t size = first.size() + body.size() + 2;
+        while (first.size() + std::to_string(size).size() + 1 + body.size() != size)
+        {
+            size = first.size() + std::to_string(size).size() + 1 + body.size();
+        }
+        header = first + std::to_string(size) + "\n" + body;
+    }
+    std::fwrite(header.data(), 1, header.size(), m_file);
+}
+
+void
+ResultWriter::FormatCsv()
+{
+    m_text.clear();
+    char field[32];
+    for (std::size_t row = 0; row < m_used; row += m_rowSize)
+    {
+        for (std::size_t i = 0; i < m_columns.size(); ++i)
+        {
+            const char* data = m_rows.data() + row + m_offsets[i];
+            int length = 0;
+            switch (m_columns[i].type)
+            {
+            case ColumnType::INT64: {
+                int64_t v;
+                std::memcpy(&v, data, sizeof(v));
+                length = std::snprintf(field, sizeof(field), "%" PRId64, v);
+                break;
+            }
+            case ColumnType::UINT64: {
+                uint64_t v;
+                std::memcpy(&v, data, sizeof(v));
+                length = std::snprintf(field, sizeof(field), "%" PRIu64, v);
+                break;
+            }
+            case ColumnType::DOUBLE: {
+                double v;
+                std::memcpy(&v, data, sizeof(v));
+                length = std::snprintf(field, sizeof(field), "%.10g", v);
+                break;
+            }
+            }
+            if (i > 0)
+            {
+                m_text += ',';
+            }
+            m_text.append(field, length);
+        }
+        m_text += '\n';
+    }
+}
+
+void
+ResultWriter::Flush()
+{
+    if (!m_file)
+    {
+        return;
+    }
+    if (!m_headerWritten && !m_columns.empty())
+    {
+        WriteHeader();
+    }
+    if (m_used == 0)
+    {
+        return;
+    }
+    if (m_format == Format::CSV)
+    {
+        FormatCsv();
+        std::fwrite(m_text.data(), 1, m_text.size(), m_file);
+    }
+    else
+    {
+        std::fwrite(m_rows.data(), 1, m_used, m_file);
+    }
+    m_used = 0;
+}
+
+void
+ResultWriter::Close()
+{
+    if (!m_file)
+    {
+        return;
+    }
+    Flush();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+uint64_t
+ResultWriter::GetNRows() const
+{
+    return m_nRows;
+}
+
+} // namespace ns3
@@ -0,0 +1,244 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_RESULT_WRITER_H
+#define SCRATCH_RESULT_WRITER_H
+
+// Buffered writer for typed result tables (time series, per-flow counters).
+
+#include "ns3/abort.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Appends typed rows to a large in-memory buffer and writes them to a file
+ * only when the buffer is full or when the writer is closed.
+ *
+ * Both formats start with a schema header:
+ *
+ *     # ns3-results 1
+ *     # <key>=<value>            one line per metadata entry
+ *     # columns=time:double,flow:uint64,...
+ *
+ * In CSV format the header is followed by a line with the column names and
+ * one line per row; pandas.read_csv(file, comment='#') loads it. In binary
+ * format the first line also holds the size of the header in bytes
+ * ("# ns3-results 1 <size>"), and the header is followed by packed rows in
+ * the native (little-endian) byte order, which numpy.fromfile() loads
+ * directly with offset=<size> and a structured dtype built from the columns
+ * line (int64 is "<i8", uint64 "<u8", double "<f8").
+ */
+class ResultWriter
+{
+  public:
+    /// File format
+    enum class Format
+    {
+        CSV,
+        BINARY
+    };
+
+    /// Type of a column
+    enum class ColumnType
+    {
+        INT64,
+        UINT64,
+        DOUBLE
+    };
+
+    /**
+     * @param filename the output file
+     * @param format the file format
+     * @param bufferSize size of the row buffer in bytes
+     */
+    ResultWriter(const std::string& filename,
+                 Format format,
+                 std::size_t bufferSize = 8 * 1024 * 1024);
+
+    /**
+     * Flushes the buffered rows and closes the file.
+     */
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /**
+     * Parse a format name.
+     *
+     * @param name "csv" or "binary"
+     * @return the format
+     */
+    static Format GetFormat(const std::string& name);
+
+    /**
+     * Add a metadata entry to the header, e.g. a scenario parameter. Must be
+     * called before the first row is added.
+     *
+     * @param key the key
+     * @param value the value; it must not contain a newline
+     */
+    void AddMetadata(const std::string& key, const std::string& value);
+
+    /**
+     * Add a metadata entry to the header.
+     *
+     * @param key the key
+     * @param value the value
+     */
+    template <typename T>
+    void AddMetadata(const std::string& key, const T& value);
+
+    /**
+     * Add a column. Must be called before the first row is added.
+     *
+     * @param name the name of the column
+     * @param type the type of the column
+     */
+    void AddColumn(const std::string& name, ColumnType type);
+
+    /**
+     * Append a row, with one value per column in column order. Each value is
+     * converted to the type of its column.
+     *
+     * @param values the values
+     */
+    template <typename... Ts>
+    void AddRow(Ts... values);
+
+    /**
+     * Write the buffered rows to the file.
+     */
+    void Flush();
+
+    /**
+     * Flush the buffered rows and close the file. Further rows are rejected.
+     */
+    void Close();
+
+    /**
+     * @return the number of rows added so far
+     */
+    uint64_t GetNRows() const;
+
+  private:
+    /// A column of the table
+    struct Column
+    {
+        std::string name; //!< Column name
+        ColumnType type;  //!< Column type
+    };
+
+    /**
+     * Store one value of the row being appended.
+     *
+     * @param column the index of the column
+     * @param value the value
+     */
+    template <typename T>
+    void Put(std::size_t column, T value);
+
+    /**
+     * Freeze the schema and write the header.
+     */
+    void WriteHeader();
+
+    /**
+     * Format the buffered rows as CSV into m_text.
+     */
+    void FormatCsv();
+
+    std::string m_filename;                                    //!< Output file name
+    Format m_format;                                           //!< Output format
+    std::FILE* m_file{nullptr};                                //!< Output file
+    std::vector<std::pair<std::string, std::string>> m_metadata; //!< Header metadata
+    std::vector<Column> m_columns;                             //!< Schema
+    std::vector<std::size_t> m_offsets;                        //!< Byte offset of each column in a row
+    std::size_t m_rowSize{0};                                  //!< Size of a packed row
+    std::vector<char> m_rows;                                  //!< Packed rows not yet written
+    std::size_t m_used{0};                                     //!< Bytes of m_rows in use
+    std::string m_text;                                        //!< CSV formatting buffer
+    uint64_t m_nRows{0};                                       //!< Rows added so far
+    bool m_headerWritten{false};                               //!< Whether the schema is frozen
+};
+
+template <typename T>
+void
+ResultWriter::AddMetadata(const std::string& key, const T& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        AddMetadata(key, std::string(value ? "1" : "0"));
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.10g", static_cast<double>(value));
+        AddMetadata(key, std::string(text));
+    }
+    else
+    {
+        AddMetadata(key, std::string(value));
+    }
+}
+
+template <typename... Ts>
+void
+ResultWriter::AddRow(Ts... values)
+{
+    NS_ABORT_MSG_IF(!m_file, "Result file " << m_filename << " is closed");
+    NS_ABORT_MSG_IF(sizeof...(Ts) != m_columns.size(),
+                    "Row has " << sizeof...(Ts) << " values for " << m_columns.size()
+                               << " columns");
+    if (!m_headerWritten)
+    {
+        WriteHeader();
+    }
+    if (m_used + m_rowSize > m_rows.size())
+    {
+        Flush();
+    }
+    std::size_t column = 0;
+    (Put(column++, values), ...);
+    m_used += m_rowSize;
+    ++m_nRows;
+}
+
+template <typename T>
+void
+ResultWriter::Put(std::size_t column, T value)
+{
+    char* field = m_rows.data() + m_used + m_offsets[column];
+    switch (m_columns[column].type)
+    {
+    case ColumnType::INT64: {
+        auto v = static_cast<int64_t>(value);
+        std::memcpy(field, &v, sizeof(v));
+        break;
+    }
+    case ColumnType::UINT64: {
+        auto v = static_cast<uint64_t>(value);
+        std::memcpy(field, &v, sizeof(v));
+        break;
+    }
+    case ColumnType::DOUBLE: {
+        auto v = static_cast<double>(value);
+        std::memcpy(field, &v, sizeof(v));
+        break;
+    }
+    }
+}
+
+} // namespace ns3
+
+#endif /* SCRATCH_RESULT_WRITER_H */
@@ -0,0 +1,170 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "saturating-sender.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SaturatingSender");
+
+NS_OBJECT_ENSURE_REGISTERED(SaturatingSender);
+
+TypeId
+SaturatingSender::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SaturatingSender")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<SaturatingSender>()
+            .AddAttribute("Remote",
+                          "Address and port of the receiver",
+                          AddressValue(),
+                          MakeAddressAccessor(&SaturatingSender::m_peer),
+                          MakeAddressChecker())
+            .AddAttribute("SendSize",
+                          "Bytes given to the socket per send",
+                          UintegerValue(1448),
+                          MakeUintegerAccessor(&SaturatingSender::m_sendSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxBytes",
+                          "Bytes to send, 0 for no limit",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&SaturatingSender::m_maxBytes),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("Lean",
+                          "Send the segments without the TCP timestamp and SACK options",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&SaturatingSender::m_lean),
+                          MakeBooleanChecker())
+            .AddTraceSource("Tx",
+                            "A packet is about to be given to the socket",
+                            MakeTraceSourceAccessor(&SaturatingSender::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+SaturatingSender::SaturatingSender() = default;
+
+SaturatingSender::~SaturatingSender() = default;
+
+uint64_t
+SaturatingSender::GetTotalTx() const
+{
+    return m_totalTx;
+}
+
+Ptr<Socket>
+SaturatingSender::GetSocket() const
+{
+    return m_socket;
+}
+
+void
+SaturatingSender::DoDispose()
+{
+    m_socket = nullptr;
+    m_template = nullptr;
+    Application::DoDispose();
+}
+
+void
+SaturatingSender::StartApplication()
+{
+    if (m_socket)
+    {
+        return;
+    }
+    m_template = Create<Packet>(m_sendSize);
+    m_socket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+    if (m_lean)
+    {
+        // Not offered in the SYN, so neither end adds them to its segments
+        m_socket->SetAttribute("Timestamp", BooleanValue(false));
+        m_socket->SetAttribute("Sack", BooleanValue(false));
+    }
+    int bound = Inet6SocketAddress::IsMatchingType(m_peer) ? m_socket->Bind6() : m_socket->Bind();
+    NS_ABORT_MSG_IF(bound == -1, "Cannot bind the socket");
+    m_socket->SetConnectCallback(MakeCallback(&SaturatingSender::ConnectionSucceeded, this),
+                                 MakeCallback(&SaturatingSender::ConnectionFailed, this));
+    m_socket->SetSendCallback(MakeCallback(&SaturatingSender::DataSent, this));
+    m_socket->ShutdownRecv();
+    m_socket->Connect(m_peer);
+}
+
+void
+SaturatingSender::StopApplication()
+{
+    if (m_socket)
+    {
+        m_socket->Close();
+        m_connected = false;
+    }
+}
+
+void
+SaturatingSender::Fill()
+{
+    while (m_connected && (m_maxBytes == 0 || m_totalTx < m_maxBytes))
+    {
+        uint32_t size = m_socket->GetTxAvailable();
+        if (m_maxBytes > 0)
+        {
+            size = std::min<uint64_t>(size, m_maxBytes - m_totalTx);
+        }
+        size = std::min(size, m_sendSize);
+        if (size == 0)
+        {
+            break;
+        }
+        Ptr<Packet> packet =
+            size == m_sendSize ? m_template->Copy() : m_template->CreateFragment(0, size);
+        m_txTrace(packet);
+        int sent = m_socket->Send(packet);
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_totalTx += sent;
+    }
+    if (m_connected && m_maxBytes > 0 && m_totalTx >= m_maxBytes)
+    {
+        m_socket->Close();
+        m_connected = false;
+    }
+}
+
+void
+SaturatingSender::ConnectionSucceeded(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    m_connected = true;
+    Fill();
+}
+
+void
+SaturatingSender::ConnectionFailed(Ptr<Socket> socket)
+{
+    NS_LOG_WARN("Connection to the receiver failed");
+}
+
+void
+SaturatingSender::DataSent(Ptr<Socket> socket, uint32_t available)
+{
+    Fill();
+}
+
+} // namespace ns3
@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_SATURATING_SENDER_H
+#define SCRATCH_SATURATING_SENDER_H
+
+// TCP sender keeping the send buffer full, without timers or per-send payload allocations.
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+class Packet;
+class Socket;
+
+/**
+ * Bulk TCP sender for saturation tests. Unlike an OnOffApplication at a
+ * rate above the link capacity, no event is scheduled per packet: the send
+ * buffer is topped up from the connection and send callbacks, i.e. whenever
+ * TCP frees space in it. Every send is a copy-on-write copy (or fragment) of
+ * one zero-filled template packet, whose payload is never materialized.
+ *
+ * In lean mode (the Lean attribute) the connection is opened without the
+ * timestamp and SACK options, so neither end serializes, parses or
+ * processes TCP options on every segment. Checksums and packet metadata
+ * need nothing here: ns-3 leaves both off unless enabled.
+ */
+class SaturatingSender : public Application
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SaturatingSender();
+    ~SaturatingSender() override;
+
+    /**
+     * @return the bytes given to the socket
+     */
+    uint64_t GetTotalTx() const;
+
+    /**
+     * @return the socket, created when the application starts
+     */
+    Ptr<Socket> GetSocket() const;
+
+  private:
+    void DoDispose() override;
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /**
+     * Fill the send buffer.
+     */
+    void Fill();
+
+    /**
+     * Start filling once connected.
+     *
+     * @param socket the socket
+     */
+    void ConnectionSucceeded(Ptr<Socket> socket);
+
+    /**
+     * Report a failed connection.
+     *
+     * @param socket the socket
+     */
+    void ConnectionFailed(Ptr<Socket> socket);
+
+    /**
+     * Fill the space freed in the send buffer.
+     *
+     * @param socket the socket
+     * @param available the free space
+     */
+    void DataSent(Ptr<Socket> socket, uint32_t available);
+
+    Address m_peer;      //!< Address of the receiver
+    uint32_t m_sendSize; //!< Bytes per send
+    uint64_t m_maxBytes; //!< Bytes to send, 0 for no limit
+    bool m_lean;         //!< Whether the TCP options are left out
+
+    Ptr<Socket> m_socket;    //!< Connected socket
+    Ptr<Packet> m_template;  //!< Zero-filled packet of m_sendSize bytes
+    bool m_connected{false}; //!< Whether the connection is established
+    uint64_t m_totalTx{0};   //!< Bytes given to the socket
+
+    /// Packets about to be given to the socket
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_SATURATING_SENDER_H */
@@ -0,0 +1,109 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "scenario-profile.h"
+
+#include "ns3/simulator.h"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace ns3
+{
+
+namespace
+{
+
+/// Prefix of the profile line
+const std::string PROFILE_PREFIX = "Profile:";
+
+} // namespace
+
+ScenarioProfile::ScenarioProfile()
+    : m_start(std::chrono::steady_clock::now()),
+      m_setupEnd(m_start)
+{
+    m_report.mainTime = std::chrono::duration<double>(m_start.time_since_epoch()).count();
+}
+
+void
+ScenarioProfile::EndSetup()
+{
+    m_setupEnd = std::chrono::steady_clock::now();
+    m_report.setupSeconds = std::chrono::duration<double>(m_setupEnd - m_start).count();
+}
+
+void
+ScenarioProfile::EndRun()
+{
+    m_report.runSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - m_setupEnd).count();
+    m_report.events = Simulator::GetEventCount();
+    m_report.simulatedSeconds = Simulator::Now().GetSeconds();
+}
+
+void
+ScenarioProfile::Report(std::ostream& os) const
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << PROFILE_PREFIX << " setupSeconds=" << m_report.setupSeconds
+       << " runSeconds=" << m_report.runSeconds << " events=" << m_report.events
+       << " simulatedSeconds=" << m_report.simulatedSeconds << " mainTime=" << std::fixed
+       << std::setprecision(6) << m_report.mainTime << std::endl;
+    os.flags(flags);
+    os.precision(precision);
+}
+
+bool
+ParseProfileReport(const std::string& output, ProfileReport& report)
+{
+    std::istringstream lines(output);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.compare(0, PROFILE_PREFIX.size(), PROFILE_PREFIX) != 0)
+        {
+            continue;
+        }
+        std::istringstream fields(line.substr(PROFILE_PREFIX.size()));
+        std::string field;
+        int found = 0;
+        while (fields >> field)
+        {
+            auto equal = field.find('=');
+            if (equal == std::string::npos)
+            {
+                continue;
+            }
+            std::string key = field.substr(0, equal);
+            std::istringstream value(field.substr(equal + 1));
+            if (key == "setupSeconds" && value >> report.setupSeconds)
+            {
+                ++found;
+            }
+            else if (key == "runSeconds" && value >> report.runSeconds)
+            {
+                ++found;
+            }
+            else if (key == "events" && value >> report.events)
+            {
+                ++found;
+            }
+            else if (key == "simulatedSeconds" && value >> report.simulatedSeconds)
+            {
+                ++found;
+            }
+            else if (key == "mainTime")
+            {
+                value >> report.mainTime;
+            }
+        }
+        return found == 4;
+    }
+    return false;
+}
+
+} // namespace ns3
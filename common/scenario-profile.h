@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_SCENARIO_PROFILE_H
+#define SCRATCH_SCENARIO_PROFILE_H
+
+// Setup and run time of a scenario, reported on one machine-readable line.
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Measurements of one simulation, as printed by ScenarioProfile::Report().
+ */
+struct ProfileReport
+{
+    double setupSeconds{0};     //!< Wall time from construction to EndSetup()
+    double runSeconds{0};       //!< Wall time from EndSetup() to EndRun()
+    uint64_t events{0};         //!< Events executed by the simulator
+    double simulatedSeconds{0}; //!< Simulation time reached
+    double mainTime{0};         //!< steady_clock time of the construction in seconds
+};
+
+/**
+ * Splits the wall time of a scenario into setup (building the topology) and
+ * run (Simulator::Run()), and counts the events executed. Construct it at
+ * the top of main(), call EndSetup() just before Simulator::Run(), EndRun()
+ * just after it and Report() before Simulator::Destroy().
+ *
+ * The time of the construction is reported too, on the steady clock, which
+ * is shared by all processes on Linux (CLOCK_MONOTONIC): the parent of the
+ * scenario subtracts the time it started the process to get the startup
+ * time, i.e. loading the libraries and running the static initializers,
+ * such as the TypeId registrations of every linked module.
+ */
+class ScenarioProfile
+{
+  public:
+    ScenarioProfile();
+
+    /**
+     * Mark the end of the setup.
+     */
+    void EndSetup();
+
+    /**
+     * Mark the end of the run and read the event count and time of the simulator.
+     */
+    void EndRun();
+
+    /**
+     * Print the measurements as one line:
+     * "Profile: setupSeconds=<s> runSeconds=<s> events=<n> simulatedSeconds=<s> mainTime=<s>".
+     *
+     * @param os the output stream
+     */
+    void Report(std::ostream& os) const;
+
+  private:
+    std::chrono::steady_clock::time_point m_start;    //!< Construction time
+    std::chrono::steady_clock::time_point m_setupEnd; //!< Time of EndSetup()
+    ProfileReport m_report;                           //!< Measurements
+};
+
+/**
+ * Find the line printed by ScenarioProfile::Report() in the output of a
+ * scenario. mainTime is left at zero if the line has none.
+ *
+ * @param output the console output of the scenario
+ * @param report receives the measurements
+ * @return false if the output has no profile line
+ */
+bool ParseProfileReport(const std::string& output, ProfileReport& report);
+
+} // namespace ns3
+
+#endif /* SCRATCH_SCENARIO_PROFILE_H */
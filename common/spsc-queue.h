@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_SPSC_QUEUE_H
+#define SCRATCH_SPSC_QUEUE_H
+
+// Bounded lock-free queue between one producer thread and one consumer thread.
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Fixed-capacity ring buffer for exactly one producer and one consumer
+ * thread. TryPush() and TryPop() never block or take a lock; Push() and Pop()
+ * sleep on the opposite index (std::atomic::wait) when the queue is full or
+ * empty, so an idle consumer does not spin.
+ */
+template <typename T>
+class SpscQueue
+{
+  public:
+    /**
+     * @param capacity the maximum number of queued elements, rounded up to a
+     *        power of two
+     */
+    explicit SpscQueue(std::size_t capacity);
+
+    /**
+     * Append an element if the queue is not full. Producer thread only.
+     *
+     * @param value the element
+     * @return false if the queue is full
+     */
+    bool TryPush(const T& value);
+
+    /**
+     * Append an element, waiting while the queue is full. Producer thread only.
+     *
+     * @param value the element
+     */
+    void Push(const T& value);
+
+    /**
+     * Remove the oldest element if the queue is not empty. Consumer thread only.
+     *
+     * @param value receives the element
+     * @return false if the queue is empty
+     */
+    bool TryPop(T& value);
+
+    /**
+     * Remove the oldest element, waiting while the queue is empty. Consumer
+     * thread only.
+     *
+     * @return the element
+     */
+    T Pop();
+
+  private:
+    /// Keeps the producer and consumer indices on separate cache lines
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::vector<T> m_slots;                                 //!< Ring buffer
+    std::size_t m_mask;                                     //!< Capacity minus one
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_head{0}; //!< Next element to pop
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_tail{0}; //!< Next free slot
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t capacity)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    m_slots.resize(size);
+    m_mask = size - 1;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::TryPush(const T& value)
+{
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+    {
+        return false;
+    }
+    m_slots[tail & m_mask] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_tail.notify_one();
+    return true;
+}
+
+template <typename T>
+void
+SpscQueue<T>::Push(const T& value)
+{
+    while (!TryPush(value))
+    {
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        if (m_tail.load(std::memory_order_relaxed) - head > m_mask)
+        {
+            m_head.wait(head, std::memory_order_acquire);
+        }
+    }
+}
+
+template <typename T>
+bool
+SpscQueue<T>::TryPop(T& value)
+{
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    value = m_slots[head & m_mask];
+    m_head.store(head + 1, std::memory_order_release);
+    m_head.notify_one();
+    return true;
+}
+
+template <typename T>
+T
+SpscQueue<T>::Pop()
+{
+    T value;
+    while (!TryPop(value))
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        m_tail.wait(head, std::memory_order_acquire);
+    }
+    return value;
+}
+
+} // namespace ns3
+
+#endif /* SCRATCH_SPSC_QUEUE_H */
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "station-layout.h"
+
+#include "ns3/abort.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+Ptr<PositionAllocator>
+CreateStationLayout(const std::string& topology, uint32_t nStations, double distance)
+{
+    NS_ABORT_MSG_IF(nStations == 0, "At least one station is needed");
+
+    if (topology == "disk")
+    {
+        Ptr<UniformDiscPositionAllocator> disk = CreateObject<UniformDiscPositionAllocator>();
+        disk->SetRho(distance);
+        disk->SetX(0.0);
+        disk->SetY(0.0);
+        return disk;
+    }
+
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator>();
+    if (topology == "ring")
+    {
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            double angle = M_PI + 2 * M_PI * i / nStations;
+            positions->Add(Vector(distance * std::cos(angle), distance * std::sin(angle), 0.0));
+        }
+    }
+    else if (topology == "line")
+    {
+        // An even number of points, none of them at the origin
+        uint32_t points = nStations + nStations % 2;
+        double step = 2 * distance / (points - 1);
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            positions->Add(Vector(-distance + step * i, 0.0, 0.0));
+        }
+    }
+    else if (topology == "grid")
+    {
+        // With an odd number of columns the middle cell is the AP, which is skipped
+        auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(nStations)));
+        if (columns % 2 == 1 && columns * columns - 1 < nStations)
+        {
+            ++columns;
+        }
+        double step = columns > 1 ? 2 * distance / (columns - 1) : 0;
+        uint32_t middle = columns % 2 == 1 ? columns * columns / 2 : columns * columns;
+        for (uint32_t cell = 0, placed = 0; placed < nStations; ++cell)
+        {
+            if (cell == middle)
+            {
+                continue;
+            }
+            positions->Add(Vector(-distance + step * (cell % columns),
+                                  -distance + step * (cell / columns),
+                                  0.0));
+            ++placed;
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown topology '" << topology << "', use ring, line, grid or disk");
+    }
+    return positions;
+}
+
+} // namespace ns3
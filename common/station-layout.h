@@ -0,0 +1,45 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_STATION_LAYOUT_H
+#define SCRATCH_STATION_LAYOUT_H
+
+// Placement of the stations of a single-AP scenario around the access point.
+
+#include "ns3/position-allocator.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Create the position allocator of @p nStations stations around an access
+ * point at the origin. The geometries are:
+ *
+ *  - "ring": evenly spaced on a circle of radius @p distance, the first
+ *    station at (-distance, 0); two stations sit on both sides of the AP;
+ *  - "line": evenly spaced on the x axis from -distance towards +distance,
+ *    on an even number of points so that none is at the AP (an odd number
+ *    of stations leaves the point at +distance empty);
+ *  - "grid": on a square grid spanning [-distance, distance] in x and y,
+ *    filled row by row, skipping the middle cell of an odd number of
+ *    columns, where the AP is;
+ *  - "disk": uniformly at random in a disk of radius @p distance, drawn from
+ *    the random stream of the allocator as the stations are installed.
+ *
+ * @param topology the geometry: ring, line, grid or disk
+ * @param nStations the number of stations
+ * @param distance the radius (or half width) of the layout in meters
+ * @return the position allocator, to be used for the stations only
+ */
+Ptr<PositionAllocator> CreateStationLayout(const std::string& topology,
+                                           uint32_t nStations,
+                                           double distance);
+
+} // namespace ns3
+
+#endif /* SCRATCH_STATION_LAYOUT_H */
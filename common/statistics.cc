@@ -0,0 +1,167 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "statistics.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * Continued fraction of the regularized incomplete beta function
+ * (modified Lentz method).
+ *
+ * @param a first shape parameter
+ * @param b second shape parameter
+ * @param x the integration bound, in [0, 1]
+ * @return the continued fraction
+ */
+double
+BetaContinuedFraction(double a, double b, double x)
+{
+    const double tiny = 1e-300;
+    double c = 1;
+    double d = 1 - (a + b) * x / (a + 1);
+    d = 1 / (std::fabs(d) < tiny ? tiny : d);
+    double h = d;
+    for (int m = 1; m <= 300; ++m)
+    {
+        double m2 = 2.0 * m;
+        double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+        d = 1 + aa * d;
+        d = 1 / (std::fabs(d) < tiny ? tiny : d);
+        c = 1 + aa / c;
+        c = std::fabs(c) < tiny ? tiny : c;
+        h *= d * c;
+        aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+        d = 1 + aa * d;
+        d = 1 / (std::fabs(d) < tiny ? tiny : d);
+        c = 1 + aa / c;
+        c = std::fabs(c) < tiny ? tiny : c;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1) < 1e-15)
+        {
+            break;
+        }
+    }
+    return h;
+}
+
+/**
+ * Regularized incomplete beta function I_x(a, b).
+ *
+ * @param a first shape parameter
+ * @param b second shape parameter
+ * @param x the integration bound, in [0, 1]
+ * @return I_x(a, b)
+ */
+double
+IncompleteBeta(double a, double b, double x)
+{
+    if (x <= 0)
+    {
+        return 0;
+    }
+    if (x >= 1)
+    {
+        return 1;
+    }
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                            a * std::log(x) + b * std::log1p(-x));
+    if (x < (a + 1) / (a + b + 2))
+    {
+        return front * BetaContinuedFraction(a, b, x) / a;
+    }
+    return 1 - front * BetaContinuedFraction(b, a, 1 - x) / b;
+}
+
+/**
+ * Cumulative distribution function of the Student t distribution.
+ *
+ * @param t the value
+ * @param dof the degrees of freedom
+ * @return P(T <= t)
+ */
+double
+StudentTCdf(double t, double dof)
+{
+    double tail = 0.5 * IncompleteBeta(dof / 2, 0.5, dof / (dof + t * t));
+    return t >= 0 ? 1 - tail : tail;
+}
+
+} // namespace
+
+double
+StudentTQuantile(double p, uint32_t dof)
+{
+    if (p <= 0 || p >= 1 || dof == 0)
+    {
+        return std::nan("");
+    }
+    if (dof == 1)
+    {
+        return std::tan(M_PI * (p - 0.5));
+    }
+    // The CDF is monotonic: bracket the quantile, then bisect
+    double low = -1;
+    double high = 1;
+    while (StudentTCdf(low, dof) > p)
+    {
+        low *= 2;
+    }
+    while (StudentTCdf(high, dof) < p)
+    {
+        high *= 2;
+    }
+    for (int i = 0; i < 100 && high - low > 1e-12; ++i)
+    {
+        double mid = (low + high) / 2;
+        if (StudentTCdf(mid, dof) < p)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return (low + high) / 2;
+}
+
+SampleSummary
+Summarize(const std::vector<double>& samples, double confidence)
+{
+    SampleSummary summary;
+    summary.count = samples.size();
+    if (samples.empty())
+    {
+        return summary;
+    }
+    double sum = 0;
+    for (double x : samples)
+    {
+        sum += x;
+    }
+    summary.mean = sum / samples.size();
+    if (samples.size() < 2)
+    {
+        return summary;
+    }
+    double squares = 0;
+    for (double x : samples)
+    {
+        squares += (x - summary.mean) * (x - summary.mean);
+    }
+    summary.stddev = std::sqrt(squares / (samples.size() - 1));
+    double t = StudentTQuantile(0.5 + confidence / 2, samples.size() - 1);
+    summary.halfWidth = t * summary.stddev / std::sqrt(samples.size());
+    return summary;
+}
+
+} // namespace ns3
@@ -0,0 +1,47 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_STATISTICS_H
+#define SCRATCH_STATISTICS_H
+
+// Small-sample statistics used to report results over several runs.
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Mean and confidence interval of a set of samples.
+ */
+struct SampleSummary
+{
+    uint32_t count{0};   //!< Number of samples
+    double mean{0};      //!< Sample mean
+    double stddev{0};    //!< Sample standard deviation
+    double halfWidth{0}; //!< Half width of the confidence interval of the mean
+};
+
+/**
+ * Quantile of the Student t distribution.
+ *
+ * @param p the cumulative probability, in (0, 1)
+ * @param dof the degrees of freedom (at least 1)
+ * @return the value t such that P(T <= t) = p
+ */
+double StudentTQuantile(double p, uint32_t dof);
+
+/**
+ * Summarize independent samples with a Student t confidence interval.
+ *
+ * @param samples the samples
+ * @param confidence the confidence level of the interval
+ * @return the summary; the half width is zero with fewer than two samples
+ */
+SampleSummary Summarize(const std::vector<double>& samples, double confidence = 0.95);
+
+} // namespace ns3
+
+#endif /* SCRATCH_STATISTICS_H */
@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "table-error-rate-model.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/type-id.h"
+#include "ns3/wifi-tx-vector.h"
+#include "ns3/yans-error-rate-model.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED(TableErrorRateModel);
+
+TypeId
+TableErrorRateModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TableErrorRateModel")
+            .SetParent<ErrorRateModel>()
+            .SetGroupName("Wifi")
+            .AddConstructor<TableErrorRateModel>()
+            .AddAttribute("Model",
+                          "Type of the error rate model whose success rates are tabulated",
+                          TypeIdValue(YansErrorRateModel::GetTypeId()),
+                          MakeTypeIdAccessor(&TableErrorRateModel::m_modelType),
+                          MakeTypeIdChecker())
+            .AddAttribute("MinSnr",
+                          "SNR (dB) of the first entry of the tables",
+                          DoubleValue(-10),
+                          MakeDoubleAccessor(&TableErrorRateModel::m_minSnr),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MaxSnr",
+                          "SNR (dB) of the last entry of the tables",
+                          DoubleValue(60),
+                          MakeDoubleAccessor(&TableErrorRateModel::m_maxSnr),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Step",
+                          "SNR step (dB) between two entries of the tables",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&TableErrorRateModel::m_step),
+                          MakeDoubleChecker<double>(1e-3));
+    return tid;
+}
+
+std::size_t
+TableErrorRateModel::GetNTables() const
+{
+    return m_tables.size();
+}
+
+double
+TableErrorRateModel::DoGetChunkSuccessRate(WifiMode mode,
+                                           const WifiTxVector& txVector,
+                                           double snr,
+                                           uint64_t nbits,
+                                           uint8_t numRxAntennas,
+                                           WifiPpduField /* field */,
+                                           uint16_t /* staId */) const
+{
+    if (nbits == 0)
+    {
+        return 1;
+    }
+    std::size_t table = GetTable(mode, txVector, numRxAntennas);
+    double position = (10 * std::log10(snr) - m_minSnr) / m_step;
+    double value;
+    if (!(position > 0))
+    {
+        value = m_values[table];
+    }
+    else if (position >= m_entries - 1)
+    {
+        value = m_values[table + m_entries - 1];
+    }
+    else
+    {
+        auto index = static_cast<std::size_t>(position);
+        double fraction = position - index;
+        double low = m_values[table + index];
+        double high = m_values[table + index + 1];
+        if (std::isinf(low) || std::isinf(high))
+        {
+            // Next to an error-free or hopeless entry: take the nearest one
+            value = fraction < 0.5 ? low : high;
+        }
+        else
+        {
+            value = low + (high - low) * fraction;
+        }
+    }
+    return std::exp(-static_cast<double>(nbits) * std::exp(value));
+}
+
+int64_t
+TableErrorRateModel::DoAssignStreams(int64_t stream)
+{
+    return GetModel()->AssignStreams(stream);
+}
+
+void
+TableErrorRateModel::DoDispose()
+{
+    m_model = nullptr;
+    m_tables.clear();
+    m_values.clear();
+    ErrorRateModel::DoDispose();
+}
+
+Ptr<ErrorRateModel>
+TableErrorRateModel::GetModel() const
+{
+    if (!m_model)
+    {
+        ObjectFactory factory;
+        factory.SetTypeId(m_modelType);
+        m_model = factory.Create<ErrorRateModel>();
+        NS_ABORT_MSG_IF(!m_model, m_modelType.GetName() << " is not an error rate model");
+        NS_ABORT_MSG_IF(m_maxSnr <= m_minSnr, "MaxSnr must be larger than MinSnr");
+        m_entries = static_cast<uint32_t>(std::ceil((m_maxSnr - m_minSnr) / m_step)) + 1;
+    }
+    return m_model;
+}
+
+std::size_t
+TableErrorRateModel::GetTable(WifiMode mode,
+                              const WifiTxVector& txVector,
+                              uint8_t numRxAntennas) const
+{
+    // Everything the data rate of the mode, hence the success rate, depends on
+    uint64_t key = (static_cast<uint64_t>(mode.GetUid()) << 56) |
+                   (static_cast<uint64_t>(txVector.GetChannelWidth()) << 40) |
+                   (static_cast<uint64_t>(txVector.GetGuardInterval().GetNanoSeconds()) << 24) |
+                   (static_cast<uint64_t>(txVector.GetNss()) << 16) |
+                   (static_cast<uint64_t>(numRxAntennas) << 8);
+    if (key == m_lastKey)
+    {
+        return m_lastTable;
+    }
+    auto [it, inserted] = m_tables.emplace(key, m_values.size());
+    if (inserted)
+    {
+        Ptr<ErrorRateModel> model = GetModel();
+        m_values.reserve(m_values.size() + m_entries);
+        for (uint32_t i = 0; i < m_entries; ++i)
+        {
+            double snr = std::pow(10.0, (m_minSnr + i * m_step) / 10);
+            double success = model->GetChunkSuccessRate(mode, txVector, snr, 1, numRxAntennas);
+            // ln(-ln s) is -inf for an error-free bit and +inf for a hopeless one
+            m_values.push_back(std::log(-std::log(success)));
+        }
+        NS_LOG_DEBUG("Table " << m_tables.size() << " for " << mode << " built");
+    }
+    m_lastKey = key;
+    m_lastTable = it->second;
+    return m_lastTable;
+}
+
+} // namespace ns3
@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_TABLE_ERROR_RATE_MODEL_H
+#define SCRATCH_TABLE_ERROR_RATE_MODEL_H
+
+// Error rate model interpolating a table of another model.
+
+#include "ns3/error-rate-model.h"
+#include "ns3/type-id.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Error rate model answering from tables of another model (YansErrorRateModel
+ * by default), to avoid evaluating erfc and the binomial sums of the
+ * convolutional code for every chunk.
+ *
+ * The wrapped model must give chunk success rates of the form
+ * s(snr)^nbits, as the Yans and NIST models do. The per-bit rate s is
+ * tabulated on a uniform grid of SNR in dB, once per combination of mode,
+ * channel width, guard interval, number of spatial streams and receive
+ * antennas, the first time the combination is used. The table stores
+ * ln(-ln s), which is nearly linear in the SNR in dB, and is interpolated
+ * linearly; the chunk success rate is then exp(-nbits * exp(value)). With
+ * the default 0.1 dB step the success rate is within 1e-3 (absolute) of the
+ * wrapped model; SNRs outside the table are clamped to its ends, where the
+ * rate is 0 or 1 for every OFDM mode.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TableErrorRateModel() = default;
+
+    /**
+     * @return the number of tables built
+     */
+    std::size_t GetNTables() const;
+
+  private:
+    double DoGetChunkSuccessRate(WifiMode mode,
+                                 const WifiTxVector& txVector,
+                                 double snr,
+                                 uint64_t nbits,
+                                 uint8_t numRxAntennas,
+                                 WifiPpduField field,
+                                 uint16_t staId) const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+    void DoDispose() override;
+
+    /**
+     * @return the wrapped model, created on first use
+     */
+    Ptr<ErrorRateModel> GetModel() const;
+
+    /**
+     * Get the table of a combination of mode and TXVECTOR, building it on first use.
+     *
+     * @param mode the mode of the chunk
+     * @param txVector the TXVECTOR of the PPDU
+     * @param numRxAntennas the number of receive antennas
+     * @return the index of the first entry of the table in m_values
+     */
+    std::size_t GetTable(WifiMode mode,
+                         const WifiTxVector& txVector,
+                         uint8_t numRxAntennas) const;
+
+    /// First entry in m_values of the table of each key
+    using TableMap = std::unordered_map<uint64_t, std::size_t>;
+
+    TypeId m_modelType; //!< Type of the wrapped model
+    double m_minSnr;    //!< SNR of the first table entry in dB
+    double m_maxSnr;    //!< SNR of the last table entry in dB
+    double m_step;      //!< SNR step of the tables in dB
+
+    // Built on first use, from the const DoGetChunkSuccessRate()
+    mutable Ptr<ErrorRateModel> m_model;    //!< Wrapped model
+    mutable uint32_t m_entries{0};          //!< Entries per table
+    mutable TableMap m_tables;              //!< Table of each key
+    mutable std::vector<double> m_values;   //!< Entries of every table, ln(-ln s)
+    mutable uint64_t m_lastKey{UINT64_MAX}; //!< Key of the last table used
+    mutable std::size_t m_lastTable{0};     //!< First entry of that table
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_TABLE_ERROR_RATE_MODEL_H */
@@ -0,0 +1,211 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-flow-tracer.h"
+
+#include "result-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <ostream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpFlowTracer");
+
+TcpFlowTracer::TcpFlowTracer(Time start, Time width)
+    : m_start(start),
+      m_width(width)
+{
+    NS_ABORT_MSG_UNLESS(width.IsStrictlyPositive(), "The intervals must have a positive width");
+}
+
+uint32_t
+TcpFlowTracer::AddFlow(const std::string& label)
+{
+    Flow flow;
+    flow.label = label;
+    m_flows.push_back(std::move(flow));
+    return m_flows.size() - 1;
+}
+
+void
+TcpFlowTracer::Connect(uint32_t flow, Ptr<Socket> socket)
+{
+    NS_ABORT_MSG_UNLESS(DynamicCast<TcpSocketBase>(socket), "Flow " << flow << " is not TCP");
+    /* The threshold only fires once changed by a loss */
+    UintegerValue ssthresh;
+    socket->GetAttribute("InitialSlowStartThreshold", ssthresh);
+    m_flows.at(flow).state.ssthresh = ssthresh.Get();
+    auto cwnd = MakeCallback(&TcpFlowTracer::CwndChange, this).Bind(flow);
+    auto threshold = MakeCallback(&TcpFlowTracer::SsthreshChange, this).Bind(flow);
+    auto rtt = MakeCallback(&TcpFlowTracer::RttChange, this).Bind(flow);
+    auto retransmission = MakeCallback(&TcpFlowTracer::Retransmission, this).Bind(flow);
+    bool connected = socket->TraceConnectWithoutContext("CongestionWindow", cwnd) &&
+                     socket->TraceConnectWithoutContext("SlowStartThreshold", threshold) &&
+                     socket->TraceConnectWithoutContext("RTT", rtt) &&
+                     socket->TraceConnectWithoutContext("Retransmission", retransmission);
+    NS_ABORT_MSG_UNLESS(connected, "Cannot trace the socket of flow " << flow);
+}
+
+void
+TcpFlowTracer::Flush(Time end)
+{
+    for (auto& flow : m_flows)
+    {
+        Advance(flow, end);
+    }
+}
+
+uint32_t
+TcpFlowTracer::GetNFlows() const
+{
+    return m_flows.size();
+}
+
+const std::string&
+TcpFlowTracer::GetLabel(uint32_t flow) const
+{
+    return m_flows.at(flow).label;
+}
+
+Time
+TcpFlowTracer::GetIntervalStart(uint64_t interval) const
+{
+    return m_start + m_width * static_cast<int64_t>(interval);
+}
+
+const std::vector<TcpFlowTracer::Sample>&
+TcpFlowTracer::GetSamples(uint32_t flow) const
+{
+    return m_flows.at(flow).samples;
+}
+
+uint64_t
+TcpFlowTracer::GetRetransmissions(uint32_t flow) const
+{
+    return m_flows.at(flow).retransmissions;
+}
+
+void
+TcpFlowTracer::Write(ResultWriter& writer) const
+{
+    for (uint32_t flow = 0; flow < m_flows.size(); ++flow)
+    {
+        writer.AddMetadata("flow." + std::to_string(flow), m_flows[flow].label);
+    }
+    writer.AddColumn("time", ResultWriter::ColumnType::DOUBLE);
+    writer.AddColumn("flow", ResultWriter::ColumnType::UINT64);
+    writer.AddColumn("cwnd", ResultWriter::ColumnType::UINT64);
+    writer.AddColumn("ssthresh", ResultWriter::ColumnType::UINT64);
+    writer.AddColumn("rtt", ResultWriter::ColumnType::DOUBLE);
+    writer.AddColumn("retransmissions", ResultWriter::ColumnType::UINT64);
+
+    std::size_t intervals = 0;
+    for (const auto& flow : m_flows)
+    {
+        intervals = std::max(intervals, flow.samples.size());
+    }
+    for (std::size_t interval = 0; interval < intervals; ++interval)
+    {
+        double end = GetIntervalStart(interval + 1).GetSeconds();
+        for (uint32_t flow = 0; flow < m_flows.size(); ++flow)
+        {
+            const auto& samples = m_flows[flow].samples;
+            if (interval < samples.size())
+            {
+                const Sample& sample = samples[interval];
+                writer.AddRow(end,
+                              flow,
+                              sample.cwnd,
+                              sample.ssthresh,
+                              sample.rtt,
+                              sample.retransmissions);
+            }
+        }
+    }
+}
+
+void
+TcpFlowTracer::Print(std::ostream& os) const
+{
+    os << "Flow\tcwnd mean/max (KB)\tRTT mean/max (ms)\tretransmissions\n";
+    for (const auto& flow : m_flows)
+    {
+        double cwndSum = 0;
+        uint32_t cwndMax = 0;
+        double rttSum = 0;
+        float rttMax = 0;
+        uint64_t rttCount = 0;
+        for (const auto& sample : flow.samples)
+        {
+            cwndSum += sample.cwnd;
+            cwndMax = std::max(cwndMax, sample.cwnd);
+            if (sample.rtt > 0)
+            {
+                rttSum += sample.rtt;
+                rttMax = std::max(rttMax, sample.rtt);
+                ++rttCount;
+            }
+        }
+        std::size_t count = std::max<std::size_t>(flow.samples.size(), 1);
+        os << flow.label << "\t" << cwndSum / count / 1024 << "/" << cwndMax / 1024.0 << "\t"
+           << (rttCount > 0 ? rttSum / rttCount : 0) << "/" << rttMax << "\t"
+           << flow.retransmissions << "\n";
+    }
+    os.flush();
+}
+
+void
+TcpFlowTracer::Advance(Flow& flow, Time now)
+{
+    uint64_t current = now > m_start ? (now - m_start).GetTimeStep() / m_width.GetTimeStep() : 0;
+    while (flow.samples.size() < current)
+    {
+        flow.samples.push_back(flow.state);
+        flow.state.retransmissions = 0;
+    }
+}
+
+void
+TcpFlowTracer::CwndChange(uint32_t flow, uint32_t oldValue, uint32_t newValue)
+{
+    Advance(m_flows[flow], Simulator::Now());
+    m_flows[flow].state.cwnd = newValue;
+}
+
+void
+TcpFlowTracer::SsthreshChange(uint32_t flow, uint32_t oldValue, uint32_t newValue)
+{
+    Advance(m_flows[flow], Simulator::Now());
+    m_flows[flow].state.ssthresh = newValue;
+}
+
+void
+TcpFlowTracer::RttChange(uint32_t flow, Time oldValue, Time newValue)
+{
+    Advance(m_flows[flow], Simulator::Now());
+    m_flows[flow].state.rtt = newValue.GetSeconds() * 1e3;
+}
+
+void
+TcpFlowTracer::Retransmission(uint32_t flow,
+                              Ptr<const Packet> packet,
+                              const TcpHeader& header,
+                              const Address& localAddr,
+                              const Address& peerAddr,
+                              Ptr<const TcpSocketBase> socket)
+{
+    Advance(m_flows[flow], Simulator::Now());
+    ++m_flows[flow].state.retransmissions;
+    ++m_flows[flow].retransmissions;
+}
+
+} // namespace ns3
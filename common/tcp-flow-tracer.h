@@ -0,0 +1,199 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_TCP_FLOW_TRACER_H
+#define SCRATCH_TCP_FLOW_TRACER_H
+
+// Per-flow congestion window, slow start threshold, RTT and retransmission
+// time series from the trace sources of TCP sockets.
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Address;
+class Packet;
+class ResultWriter;
+class Socket;
+class TcpHeader;
+class TcpSocketBase;
+
+/**
+ * Records the state of the congestion control of TCP flows from the
+ * "CongestionWindow", "SlowStartThreshold", "RTT" and "Retransmission" trace
+ * sources of their sockets.
+ *
+ * The traces fire on every ACK, so rather than every change, one sample per
+ * flow and interval of fixed width is kept: the congestion window, the slow
+ * start threshold and the smoothed RTT at the end of the interval, and the
+ * number of segments retransmitted during it. Samples are appended lazily
+ * when the next trace of the flow fires (and by Flush()), so that no event
+ * is scheduled per interval; a flow holds 16 bytes per interval.
+ */
+class TcpFlowTracer
+{
+  public:
+    /// State of a flow at the end of an interval
+    struct Sample
+    {
+        uint32_t cwnd;            //!< Congestion window in bytes
+        uint32_t ssthresh;        //!< Slow start threshold in bytes
+        float rtt;                //!< Smoothed RTT in ms, 0 before the first measurement
+        uint32_t retransmissions; //!< Segments retransmitted during the interval
+    };
+
+    /**
+     * @param start start time of the first interval; earlier changes fall in the first one
+     * @param width width of the intervals
+     */
+    TcpFlowTracer(Time start, Time width);
+
+    /**
+     * Register a flow. Its socket is connected later, once created.
+     *
+     * @param label the label used when reporting the flow
+     * @return the index of the flow
+     */
+    uint32_t AddFlow(const std::string& label);
+
+    /**
+     * Trace the socket of a flow. Connect it before the connection is
+     * established to record the initial window.
+     *
+     * @param flow the flow index
+     * @param socket a TCP socket (TcpSocketBase)
+     */
+    void Connect(uint32_t flow, Ptr<Socket> socket);
+
+    /**
+     * Complete the samples of every flow up to @p end. Call it once after
+     * Simulator::Run().
+     *
+     * @param end the end of the traced period
+     */
+    void Flush(Time end);
+
+    /**
+     * @return the number of flows
+     */
+    uint32_t GetNFlows() const;
+
+    /**
+     * @param flow the flow index
+     * @return the label of the flow
+     */
+    const std::string& GetLabel(uint32_t flow) const;
+
+    /**
+     * @param interval the interval index
+     * @return the start time of the interval
+     */
+    Time GetIntervalStart(uint64_t interval) const;
+
+    /**
+     * @param flow the flow index
+     * @return the samples of the flow, one per completed interval
+     */
+    const std::vector<Sample>& GetSamples(uint32_t flow) const;
+
+    /**
+     * @param flow the flow index
+     * @return the segments retransmitted by the flow
+     */
+    uint64_t GetRetransmissions(uint32_t flow) const;
+
+    /**
+     * Write the samples as one row per interval and flow, with the end of
+     * the interval, the flow index, cwnd and ssthresh in bytes, the RTT in ms
+     * and the retransmissions. The writer must have no columns yet.
+     *
+     * @param writer the result writer
+     */
+    void Write(ResultWriter& writer) const;
+
+    /**
+     * Print one line per flow: mean and maximum congestion window, mean and
+     * maximum RTT and retransmissions.
+     *
+     * @param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /// State of a flow
+    struct Flow
+    {
+        std::string label;           //!< Label of the flow
+        Sample state{0, 0, 0, 0};    //!< Current state, retransmissions of the interval
+        uint64_t retransmissions{0}; //!< Segments retransmitted
+        std::vector<Sample> samples; //!< Completed intervals
+    };
+
+    /**
+     * Append the samples of the intervals of a flow completed before @p now.
+     *
+     * @param flow the flow
+     * @param now the current time
+     */
+    void Advance(Flow& flow, Time now);
+
+    /**
+     * Trace sink for TcpSocketBase::CongestionWindow.
+     *
+     * @param flow the flow index
+     * @param oldValue the previous window
+     * @param newValue the new window
+     */
+    void CwndChange(uint32_t flow, uint32_t oldValue, uint32_t newValue);
+
+    /**
+     * Trace sink for TcpSocketBase::SlowStartThreshold.
+     *
+     * @param flow the flow index
+     * @param oldValue the previous threshold
+     * @param newValue the new threshold
+     */
+    void SsthreshChange(uint32_t flow, uint32_t oldValue, uint32_t newValue);
+
+    /**
+     * Trace sink for TcpSocketBase::RTT.
+     *
+     * @param flow the flow index
+     * @param oldValue the previous smoothed RTT
+     * @param newValue the new smoothed RTT
+     */
+    void RttChange(uint32_t flow, Time oldValue, Time newValue);
+
+    /**
+     * Trace sink for TcpSocketBase::Retransmission.
+     *
+     * @param flow the flow index
+     * @param packet the retransmitted segment
+     * @param header its TCP header
+     * @param localAddr the local address
+     * @param peerAddr the peer address
+     * @param socket the socket
+     */
+    void Retransmission(uint32_t flow,
+                        Ptr<const Packet> packet,
+                        const TcpHeader& header,
+                        const Address& localAddr,
+                        const Address& peerAddr,
+                        Ptr<const TcpSocketBase> socket);
+
+    Time m_start;              //!< Start of the first interval
+    Time m_width;              //!< Width of an interval
+    std::vector<Flow> m_flows; //!< Flows, by index
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_TCP_FLOW_TRACER_H */
@@ -0,0 +1,208 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "throughput-sampler.h"
+
+#include "result-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/packet-sink.h"
+#include "ns3/simulator.h"
+
+#include <sstream>
+
+namespace ns3
+{
+
+ThroughputSampler::ThroughputSampler(Time start, Time width, uint32_t capacity)
+    : m_start(start),
+      m_width(width),
+      m_capacity(capacity)
+{
+    NS_ABORT_MSG_IF(!width.IsStrictlyPositive(), "The bucket width must be positive");
+    NS_ABORT_MSG_IF(capacity == 0, "The ring buffer must hold at least one bucket");
+}
+
+uint32_t
+ThroughputSampler::AddFlow(Ipv4Address source, const std::string& label)
+{
+    auto [it, inserted] = m_flows.emplace(source.Get(), m_labels.size());
+    NS_ABORT_MSG_IF(!inserted, "Flow from " << source << " registered twice");
+    m_labels.push_back(label);
+    m_totals.push_back(0);
+    // Flow-major layout: a new flow only appends its own ring
+    m_bytes.resize(m_bytes.size() + m_capacity, 0);
+    return it->second;
+}
+
+void
+ThroughputSampler::Connect(Ptr<PacketSink> sink)
+{
+    sink->TraceConnectWithoutContext("RxWithAddresses",
+                                     MakeCallback(&ThroughputSampler::Receive, this));
+}
+
+void
+ThroughputSampler::SetBucketCallback(BucketCallback callback)
+{
+    m_bucketCallback = std::move(callback);
+}
+
+const ThroughputSampler::BucketCallback&
+ThroughputSampler::GetBucketCallback() const
+{
+    return m_bucketCallback;
+}
+
+void
+ThroughputSampler::Receive(Ptr<const Packet> packet, const Address& from, const Address& to)
+{
+    if (!InetSocketAddress::IsMatchingType(from))
+    {
+        return;
+    }
+    Ipv4Address source = InetSocketAddress::ConvertFrom(from).GetIpv4();
+    auto it = m_flows.find(source.Get());
+    uint32_t flow;
+    if (it != m_flows.end())
+    {
+        flow = it->second;
+    }
+    else
+    {
+        std::ostringstream label;
+        label << source;
+        flow = AddFlow(source, label.str());
+    }
+
+    uint32_t size = packet->GetSize();
+    m_totals[flow] += size;
+
+    Time now = Simulator::Now();
+    if (now < m_start)
+    {
+        return;
+    }
+    uint64_t bucket = (now - m_start).GetTimeStep() / m_width.GetTimeStep();
+    if (bucket != m_current)
+    {
+        Advance(bucket);
+    }
+    m_bytes[Slot(flow, bucket)] += size;
+}
+
+void
+ThroughputSampler::Advance(uint64_t bucket)
+{
+    while (m_current < bucket)
+    {
+        if (m_bucketCallback)
+        {
+            m_bucketCallback(*this, m_current);
+        }
+        // Recycle the slot of the next bucket
+        ++m_current;
+        for (uint32_t flow = 0; flow < m_labels.size(); ++flow)
+        {
+            m_bytes[Slot(flow, m_current)] = 0;
+        }
+    }
+}
+
+void
+ThroughputSampler::Flush(Time end)
+{
+    if (end <= m_start)
+    {
+        return;
+    }
+    int64_t steps = (end - m_start).GetTimeStep();
+    int64_t width = m_width.GetTimeStep();
+    // Index of the first bucket that does not start before the end
+    auto last = static_cast<uint64_t>((steps + width - 1) / width);
+    if (last > m_current)
+    {
+        Advance(last);
+    }
+}
+
+uint32_t
+ThroughputSampler::GetNFlows() const
+{
+    return m_labels.size();
+}
+
+const std::string&
+ThroughputSampler::GetLabel(uint32_t flow) const
+{
+    return m_labels.at(flow);
+}
+
+Time
+ThroughputSampler::GetBucketStart(uint64_t bucket) const
+{
+    return m_start + m_width * static_cast<int64_t>(bucket);
+}
+
+Time
+ThroughputSampler::GetBucketWidth() const
+{
+    return m_width;
+}
+
+uint64_t
+ThroughputSampler::GetBytes(uint32_t flow, uint64_t bucket) const
+{
+    NS_ABORT_MSG_IF(bucket > m_current || m_current - bucket >= m_capacity,
+                    "Bucket " << bucket << " is no longer held by the sampler");
+    return m_bytes[Slot(flow, bucket)];
+}
+
+double
+ThroughputSampler::GetThroughput(uint32_t flow, uint64_t bucket) const
+{
+    return GetBytes(flow, bucket) * 8.0 / (1e6 * m_width.GetSeconds());
+}
+
+uint64_t
+ThroughputSampler::GetTotalBytes(uint32_t flow) const
+{
+    return m_totals.at(flow);
+}
+
+std::size_t
+ThroughputSampler::Slot(uint32_t flow, uint64_t bucket) const
+{
+    return static_cast<std::size_t>(flow) * m_capacity + bucket % m_capacity;
+}
+
+void
+AddThroughputColumns(ResultWriter& writer, const ThroughputSampler& sampler)
+{
+    for (uint32_t flow = 0; flow < sampler.GetNFlows(); ++flow)
+    {
+        writer.AddMetadata("flow." + std::to_string(flow), sampler.GetLabel(flow));
+    }
+    writer.AddColumn("time", ResultWriter::ColumnType::DOUBLE);
+    writer.AddColumn("flow", ResultWriter::ColumnType::UINT64);
+    writer.AddColumn("bytes", ResultWriter::ColumnType::UINT64);
+    writer.AddColumn("throughput", ResultWriter::ColumnType::DOUBLE);
+}
+
+void
+WriteThroughputRows(ResultWriter& writer, const ThroughputSampler& sampler, uint64_t bucket)
+{
+    double end = sampler.GetBucketStart(bucket + 1).GetSeconds();
+    for (uint32_t flow = 0; flow < sampler.GetNFlows(); ++flow)
+    {
+        writer.AddRow(end,
+                      flow,
+                      sampler.GetBytes(flow, bucket),
+                      sampler.GetThroughput(flow, bucket));
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_THROUGHPUT_SAMPLER_H
+#define SCRATCH_THROUGHPUT_SAMPLER_H
+
+// Per-flow throughput time series built from the PacketSink receive trace,
+// without polling events.
+
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Ipv4Address;
+class PacketSink;
+class ResultWriter;
+
+/**
+ * Attributes the bytes received by one or more PacketSink applications to
+ * flows (identified by the IPv4 source address) and to fixed-width time
+ * buckets.
+ *
+ * The buckets live in a ring buffer preallocated per flow; a bucket is
+ * complete once a packet falls in a later bucket (or on Flush()), at which
+ * point the bucket callback is invoked and the bucket can still be read
+ * until its slot is reused, @p capacity buckets later. No simulator event
+ * is scheduled, so the cost is one hash lookup and one addition per packet
+ * regardless of the number of flows.
+ */
+class ThroughputSampler
+{
+  public:
+    /**
+     * Callback invoked for each completed bucket, with the sampler and the
+     * index of the bucket.
+     */
+    using BucketCallback = std::function<void(const ThroughputSampler&, uint64_t)>;
+
+    /**
+     * @param start start time of the first bucket; earlier bytes only count in the totals
+     * @param width width of the buckets
+     * @param capacity number of buckets retained per flow
+     */
+    ThroughputSampler(Time start, Time width, uint32_t capacity = 16);
+
+    /**
+     * Register a flow before the simulation starts. Packets from unregistered
+     * sources create a flow labelled with the source address.
+     *
+     * @param source the IPv4 address of the sender
+     * @param label the label used when reporting the flow
+     * @return the index of the flow
+     */
+    uint32_t AddFlow(Ipv4Address source, const std::string& label);
+
+    /**
+     * Sample the packets received by a sink.
+     *
+     * @param sink the sink application
+     */
+    void Connect(Ptr<PacketSink> sink);
+
+    /**
+     * @param callback invoked for each completed bucket, in order
+     */
+    void SetBucketCallback(BucketCallback callback);
+
+    /**
+     * @return the completed bucket callback, e.g. to chain another one after it
+     */
+    const BucketCallback& GetBucketCallback() const;
+
+    /**
+     * Complete every bucket that starts before @p end. Call it once after
+     * Simulator::Run() to report the tail of the time series.
+     *
+     * @param end the end of the sampled period
+     */
+    void Flush(Time end);
+
+    /**
+     * @return the number of flows
+     */
+    uint32_t GetNFlows() const;
+
+    /**
+     * @param flow the flow index
+     * @return the label of the flow
+     */
+    const std::string& GetLabel(uint32_t flow) const;
+
+    /**
+     * @param bucket the bucket index
+     * @return the start time of the bucket
+     */
+    Time GetBucketStart(uint64_t bucket) const;
+
+    /**
+     * @return the width of the buckets
+     */
+    Time GetBucketWidth() const;
+
+    /**
+     * @param flow the flow index
+     * @param bucket the bucket index; it must be one of the last buckets still
+     *        held in the ring buffer
+     * @return the bytes received from the flow during the bucket
+     */
+    uint64_t GetBytes(uint32_t flow, uint64_t bucket) const;
+
+    /**
+     * @param flow the flow index
+     * @param bucket the bucket index, as for GetBytes()
+     * @return the throughput of the flow during the bucket in Mbit/s
+     */
+    double GetThroughput(uint32_t flow, uint64_t bucket) const;
+
+    /**
+     * @param flow the flow index
+     * @return the bytes received from the flow since the beginning of the simulation
+     */
+    uint64_t GetTotalBytes(uint32_t flow) const;
+
+  private:
+    /**
+     * Trace sink for PacketSink::RxWithAddresses.
+     *
+     * @param packet the received packet
+     * @param from the source address
+     * @param to the local address
+     */
+    void Receive(Ptr<const Packet> packet, const Address& from, const Address& to);
+
+    /**
+     * Complete the current bucket and every empty bucket before @p bucket,
+     * then make @p bucket the current one.
+     *
+     * @param bucket the new current bucket
+     */
+    void Advance(uint64_t bucket);
+
+    /**
+     * @param flow the flow index
+     * @param bucket the bucket index
+     * @return the position of the bucket of the flow in the ring buffer
+     */
+    std::size_t Slot(uint32_t flow, uint64_t bucket) const;
+
+    Time m_start;                                  //!< Start of the first bucket
+    Time m_width;                                  //!< Width of a bucket
+    uint32_t m_capacity;                           //!< Buckets retained per flow
+    uint64_t m_current{0};                         //!< Bucket being filled
+    std::vector<uint64_t> m_bytes;                 //!< Ring buffers, one per flow, flow-major
+    std::vector<uint64_t> m_totals;                //!< Total bytes per flow
+    std::vector<std::string> m_labels;             //!< Label per flow
+    std::unordered_map<uint32_t, uint32_t> m_flows; //!< IPv4 source address to flow index
+    BucketCallback m_bucketCallback;               //!< Completed bucket callback
+};
+
+/**
+ * Add the columns written by WriteThroughputRows() and the flow labels of
+ * @p sampler to the header of @p writer.
+ *
+ * @param writer the result writer
+ * @param sampler the throughput sampler
+ */
+void AddThroughputColumns(ResultWriter& writer, const ThroughputSampler& sampler);
+
+/**
+ * Write one row per flow for a completed bucket: end time of the bucket in
+ * seconds, flow index, bytes and throughput in Mbit/s.
+ *
+ * @param writer the result writer
+ * @param sampler the throughput sampler
+ * @param bucket the index of the bucket
+ */
+void WriteThroughputRows(ResultWriter& writer, const ThroughputSampler& sampler, uint64_t bucket);
+
+} // namespace ns3
+
+#endif /* SCRATCH_THROUGHPUT_SAMPLER_H */
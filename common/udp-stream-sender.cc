@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "udp-stream-sender.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("UdpStreamSender");
+
+NS_OBJECT_ENSURE_REGISTERED(UdpStreamSender);
+
+TypeId
+UdpStreamSender::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::UdpStreamSender")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<UdpStreamSender>()
+            .AddAttribute("Remote",
+                          "Address and port of the receiver",
+                          AddressValue(),
+                          MakeAddressAccessor(&UdpStreamSender::m_peer),
+                          MakeAddressChecker())
+            .AddAttribute("PacketSize",
+                          "Size of the UDP payload",
+                          UintegerValue(160),
+                          MakeUintegerAccessor(&UdpStreamSender::m_size),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Interval",
+                          "Interval between packets",
+                          TimeValue(MilliSeconds(20)),
+                          MakeTimeAccessor(&UdpStreamSender::m_interval),
+                          MakeTimeChecker(Time(1)))
+            .AddAttribute("Tos",
+                          "IP ToS of the packets; its three most significant bits are the "
+                          "Wi-Fi user priority",
+                          UintegerValue(0xc0),
+                          MakeUintegerAccessor(&UdpStreamSender::m_tos),
+                          MakeUintegerChecker<uint8_t>())
+            .AddTraceSource("Tx",
+                            "A packet is about to be given to the socket",
+                            MakeTraceSourceAccessor(&UdpStreamSender::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+UdpStreamSender::UdpStreamSender()
+    : m_phase(CreateObject<UniformRandomVariable>())
+{
+}
+
+UdpStreamSender::~UdpStreamSender() = default;
+
+uint64_t
+UdpStreamSender::GetNSent() const
+{
+    return m_sent;
+}
+
+int64_t
+UdpStreamSender::AssignStreams(int64_t stream)
+{
+    m_phase->SetStream(stream);
+    return 1;
+}
+
+void
+UdpStreamSender::DoDispose()
+{
+    m_socket = nullptr;
+    m_phase = nullptr;
+    Application::DoDispose();
+}
+
+void
+UdpStreamSender::StartApplication()
+{
+    if (!m_socket)
+    {
+        m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+        int bound = Inet6SocketAddress::IsMatchingType(m_peer) ? m_socket->Bind6()
+                                                               : m_socket->Bind();
+        NS_ABORT_MSG_IF(bound == -1 || m_socket->Connect(m_peer) == -1,
+                        "Cannot connect to the receiver");
+        m_socket->SetIpTos(m_tos);
+        m_socket->ShutdownRecv();
+    }
+    Time phase = Seconds(m_phase->GetValue(0, m_interval.GetSeconds()));
+    m_sendEvent = Simulator::Schedule(phase, &UdpStreamSender::Send, this);
+}
+
+void
+UdpStreamSender::StopApplication()
+{
+    m_sendEvent.Cancel();
+}
+
+void
+UdpStreamSender::Send()
+{
+    Ptr<Packet> packet = Create<Packet>(m_size);
+    m_txTrace(packet);
+    if (m_socket->Send(packet) >= 0)
+    {
+        ++m_sent;
+    }
+    m_sendEvent = Simulator::Schedule(m_interval, &UdpStreamSender::Send, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_UDP_STREAM_SENDER_H
+#define SCRATCH_UDP_STREAM_SENDER_H
+
+// Constant bit rate UDP sender marked with an IP ToS, for voice and video flows.
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+
+#include <cstdint>
+
+namespace ns3
+{
+
+class Packet;
+class Socket;
+
+/**
+ * Sends UDP packets of a fixed size at a fixed interval, e.g. a voice codec
+ * frame every 20 ms, from a socket whose IP ToS selects the Wi-Fi access
+ * category: the user priority is the three most significant bits of the
+ * ToS, so 0xc0 is voice (AC_VO) and 0xa0 video (AC_VI).
+ *
+ * The first packet is sent at a random time within the first interval, so
+ * that the streams of several stations started together do not send in
+ * lockstep.
+ */
+class UdpStreamSender : public Application
+{
+  public:
+    /**
+     * Register this type.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    UdpStreamSender();
+    ~UdpStreamSender() override;
+
+    /**
+     * @return the number of packets sent
+     */
+    uint64_t GetNSent() const;
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this application.
+     *
+     * @param stream first stream index to use
+     * @return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream) override;
+
+  private:
+    void DoDispose() override;
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /**
+     * Send a packet and schedule the next one.
+     */
+    void Send();
+
+    Address m_peer;                     //!< Address of the receiver
+    uint32_t m_size;                    //!< UDP payload size
+    Time m_interval;                    //!< Interval between packets
+    uint8_t m_tos;                      //!< IP ToS of the packets
+    Ptr<UniformRandomVariable> m_phase; //!< Time of the first packet within the interval
+
+    Ptr<Socket> m_socket; //!< Socket to the receiver
+    EventId m_sendEvent;  //!< Next packet
+    uint64_t m_sent{0};   //!< Packets sent
+
+    /// Packets about to be given to the socket
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_UDP_STREAM_SENDER_H */
@@ -0,0 +1,98 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "wifi-data-mode.h"
+
+#include "ns3/abort.h"
+#include "ns3/he-phy.h"
+#include "ns3/ht-phy.h"
+#include "ns3/vht-phy.h"
+
+#include <cstdlib>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * Parse the index of an MCS name.
+ *
+ * @param mcs the name of the mode, e.g. VhtMcs9
+ * @param prefix the expected prefix, e.g. VhtMcs
+ * @param maxIndex the highest index of the family
+ * @return the index
+ */
+uint8_t
+ParseMcsIndex(const std::string& mcs, const std::string& prefix, uint32_t maxIndex)
+{
+    NS_ABORT_MSG_UNLESS(mcs.size() > prefix.size() && mcs.compare(0, prefix.size(), prefix) == 0,
+                        mcs << " is not one of the " << prefix << " modes of the standard");
+    char* end = nullptr;
+    unsigned long index = std::strtoul(mcs.c_str() + prefix.size(), &end, 10);
+    NS_ABORT_MSG_UNLESS(*end == '\0' && index <= maxIndex,
+                        "Invalid MCS " << mcs << " (" << prefix << "0 to " << prefix << maxIndex
+                                       << ")");
+    return index;
+}
+
+} // namespace
+
+uint64_t
+WifiDataMode::GetPhyRate() const
+{
+    return mode.GetDataRate(channelWidth, guardInterval, nss);
+}
+
+WifiDataMode
+ParseWifiDataMode(const std::string& standard,
+                  const std::string& mcs,
+                  MHz_u channelWidth,
+                  uint8_t nss,
+                  Time guardInterval)
+{
+    WifiDataMode dataMode;
+    dataMode.channelWidth = channelWidth;
+    dataMode.nss = nss;
+    dataMode.guardInterval = guardInterval;
+    bool he = false;
+    if (standard == "n")
+    {
+        dataMode.standard = WIFI_STANDARD_80211n;
+        uint8_t index = ParseMcsIndex(mcs, "HtMcs", 31);
+        dataMode.mode = HtPhy::GetHtMcs(index);
+        NS_ABORT_MSG_UNLESS(nss == index / 8 + 1,
+                            mcs << " uses " << index / 8 + 1 << " spatial streams, not "
+                                << +nss);
+        NS_ABORT_MSG_UNLESS(channelWidth == 20 || channelWidth == 40,
+                            "802.11n channels are 20 or 40 MHz wide");
+    }
+    else if (standard == "ac" || standard == "ax")
+    {
+        he = standard == "ax";
+        dataMode.standard = he ? WIFI_STANDARD_80211ax : WIFI_STANDARD_80211ac;
+        dataMode.mode = he ? HePhy::GetHeMcs(ParseMcsIndex(mcs, "HeMcs", 11))
+                           : VhtPhy::GetVhtMcs(ParseMcsIndex(mcs, "VhtMcs", 9));
+        NS_ABORT_MSG_UNLESS(nss >= 1 && nss <= 8, "1 to 8 spatial streams are supported");
+        NS_ABORT_MSG_UNLESS(channelWidth == 20 || channelWidth == 40 || channelWidth == 80 ||
+                                channelWidth == 160,
+                            "The channels are 20, 40, 80 or 160 MHz wide");
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown standard '" << standard << "', use n, ac or ax");
+    }
+    NS_ABORT_MSG_UNLESS(dataMode.mode.IsAllowed(channelWidth, nss),
+                        mcs << " is not allowed on " << channelWidth << " MHz with " << +nss
+                            << " spatial streams");
+
+    int64_t gi = guardInterval.GetNanoSeconds();
+    bool validGi = he ? (gi == 800 || gi == 1600 || gi == 3200) : (gi == 800 || gi == 400);
+    NS_ABORT_MSG_UNLESS(validGi,
+                        "Invalid guard interval of " << gi << " ns for 802.11" << standard);
+    return dataMode;
+}
+
+} // namespace ns3
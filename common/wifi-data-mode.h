@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_WIFI_DATA_MODE_H
+#define SCRATCH_WIFI_DATA_MODE_H
+
+// Standard, channel width, spatial streams and guard interval of a constant
+// rate link, checked against its MCS, and the resulting PHY rate.
+
+#include "ns3/nstime.h"
+#include "ns3/wifi-mode.h"
+#include "ns3/wifi-standards.h"
+#include "ns3/wifi-units.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * Data transmission parameters of a link using ConstantRateWifiManager.
+ */
+struct WifiDataMode
+{
+    WifiStandard standard; //!< Standard of the devices
+    WifiMode mode;         //!< Data mode
+    MHz_u channelWidth;    //!< Channel width
+    uint8_t nss;           //!< Number of spatial streams
+    Time guardInterval;    //!< Guard interval
+
+    /**
+     * @return the PHY rate of the data frames in bit/s
+     */
+    uint64_t GetPhyRate() const;
+};
+
+/**
+ * Check the data transmission parameters of a link and resolve its mode:
+ *
+ *  - "n" (802.11n) takes HtMcs0 to HtMcs31, on 20 or 40 MHz, whose index
+ *    sets the number of spatial streams (HtMcs8 to HtMcs15 use 2 streams);
+ *  - "ac" (802.11ac) takes VhtMcs0 to VhtMcs9, on 20, 40, 80 or 160 MHz,
+ *    except the combinations that 802.11ac forbids (e.g. VhtMcs9 on 20 MHz
+ *    with one stream);
+ *  - "ax" (802.11ax) takes HeMcs0 to HeMcs11, on 20, 40, 80 or 160 MHz.
+ *
+ * The guard interval is 800 or 400 ns (short) for n and ac, and 800, 1600 or
+ * 3200 ns for ax. Invalid combinations abort.
+ *
+ * @param standard the standard: n, ac or ax
+ * @param mcs the name of the data mode, e.g. HtMcs7, VhtMcs9 or HeMcs11
+ * @param channelWidth the channel width
+ * @param nss the number of spatial streams
+ * @param guardInterval the guard interval
+ * @return the checked parameters
+ */
+WifiDataMode ParseWifiDataMode(const std::string& standard,
+                               const std::string& mcs,
+                               MHz_u channelWidth,
+                               uint8_t nss,
+                               Time guardInterval);
+
+} // namespace ns3
+
+#endif /* SCRATCH_WIFI_DATA_MODE_H */
@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "wifi-device-configurator.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-remote-station-manager.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("WifiDeviceConfigurator");
+
+WifiDeviceConfigurator&
+WifiDeviceConfigurator::SetBeMaxAmpduSize(uint32_t bytes)
+{
+    // The setter of WifiMac is private
+    return SetMacAttribute("BE_MaxAmpduSize", UintegerValue(bytes));
+}
+
+WifiDeviceConfigurator&
+WifiDeviceConfigurator::SetRtsCtsThreshold(uint32_t bytes)
+{
+    m_rtsCtsThreshold = bytes;
+    return *this;
+}
+
+WifiDeviceConfigurator&
+WifiDeviceConfigurator::SetMacAttribute(const std::string& name, const AttributeValue& value)
+{
+    TypeId::AttributeInformation info;
+    NS_ABORT_MSG_UNLESS(WifiMac::GetTypeId().LookupAttributeByName(name, &info),
+                        "WifiMac has no attribute " << name);
+    NS_ABORT_MSG_UNLESS(info.accessor->HasSetter() && (info.flags & TypeId::ATTR_SET),
+                        "Attribute " << name << " of WifiMac cannot be set");
+    Ptr<AttributeValue> checked = info.checker->CreateValidValue(value);
+    NS_ABORT_MSG_UNLESS(checked, "Invalid value for attribute " << name << " of WifiMac");
+
+    for (auto& attribute : m_macAttributes)
+    {
+        if (attribute.name == name)
+        {
+            attribute.value = checked;
+            return *this;
+        }
+    }
+    m_macAttributes.push_back({name, info.accessor, checked});
+    return *this;
+}
+
+void
+WifiDeviceConfigurator::Apply(const NetDeviceContainer& devices) const
+{
+    for (auto it = devices.Begin(); it != devices.End(); ++it)
+    {
+        auto device = DynamicCast<WifiNetDevice>(*it);
+        NS_ABORT_MSG_UNLESS(device, "Device " << (*it)->GetIfIndex() << " is not a WifiNetDevice");
+        Ptr<WifiMac> mac = device->GetMac();
+        for (const auto& attribute : m_macAttributes)
+        {
+            NS_ABORT_MSG_UNLESS(attribute.accessor->Set(PeekPointer(mac), *attribute.value),
+                                "Cannot set attribute " << attribute.name << " of the MAC");
+        }
+        if (m_rtsCtsThreshold)
+        {
+            for (uint8_t link = 0; link < device->GetNPhys(); ++link)
+            {
+                device->GetRemoteStationManager(link)->SetRtsCtsThreshold(*m_rtsCtsThreshold);
+            }
+        }
+    }
+    NS_LOG_DEBUG("Configured " << devices.GetN() << " devices");
+}
+
+} // namespace ns3
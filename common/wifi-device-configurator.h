@@ -0,0 +1,86 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_WIFI_DEVICE_CONFIGURATOR_H
+#define SCRATCH_WIFI_DEVICE_CONFIGURATOR_H
+
+// Configuration of installed Wi-Fi devices through their objects rather than Config paths.
+
+#include "ns3/attribute.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Sets parameters of the devices returned by WifiHelper::Install(), by
+ * following the pointers from each WifiNetDevice to its MAC and remote
+ * station manager. A Config::Set() on a "/NodeList/ * /DeviceList/ * /..."
+ * path instead resolves the path from the root for every call, and matches
+ * every device of every node against it, which grows with the number of
+ * nodes times the number of calls.
+ *
+ * Parameters with a public C++ setter call it. MAC attributes are resolved
+ * (name lookup and value check) once when they are set, and Apply() only
+ * calls their accessors.
+ *
+ * @code
+ * WifiDeviceConfigurator configurator;
+ * configurator.SetBeMaxAmpduSize(4000).SetRtsCtsThreshold(0);
+ * configurator.Apply(staDevices);
+ * @endcode
+ */
+class WifiDeviceConfigurator
+{
+  public:
+    /**
+     * @param bytes the maximum A-MPDU size of the best effort access category
+     * @return this configurator
+     */
+    WifiDeviceConfigurator& SetBeMaxAmpduSize(uint32_t bytes);
+
+    /**
+     * @param bytes the RTS/CTS threshold of the remote station manager
+     * @return this configurator
+     */
+    WifiDeviceConfigurator& SetRtsCtsThreshold(uint32_t bytes);
+
+    /**
+     * Set an attribute of the MAC of every device.
+     *
+     * @param name the name of an attribute of WifiMac
+     * @param value the value
+     * @return this configurator
+     */
+    WifiDeviceConfigurator& SetMacAttribute(const std::string& name, const AttributeValue& value);
+
+    /**
+     * Apply the parameters to devices.
+     *
+     * @param devices the devices, which must be WifiNetDevices
+     */
+    void Apply(const NetDeviceContainer& devices) const;
+
+  private:
+    /// A MAC attribute resolved once
+    struct MacAttribute
+    {
+        std::string name;                      //!< Name, for the error messages
+        Ptr<const AttributeAccessor> accessor; //!< Accessor of the attribute
+        Ptr<AttributeValue> value;             //!< Checked value
+    };
+
+    std::optional<uint32_t> m_rtsCtsThreshold; //!< RTS/CTS threshold, if set
+    std::vector<MacAttribute> m_macAttributes; //!< MAC attributes
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_WIFI_DEVICE_CONFIGURATOR_H */
@@ -0,0 +1,310 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "capture-statistics.h"
+
+#include "mapped-pcap-file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * @param address a MAC address packed by ParseMacHeader()
+ * @return whether it is a group (broadcast or multicast) address
+ */
+bool
+IsGroupAddress(uint64_t address)
+{
+    return (address >> 40) & 0x01;
+}
+
+/**
+ * @param address a MAC address packed by ParseMacHeader()
+ * @return the address in the usual colon-separated notation
+ */
+std::string
+FormatAddress(uint64_t address)
+{
+    if (address == 0)
+    {
+        return "unknown";
+    }
+    char text[18];
+    std::snprintf(text,
+                  sizeof(text),
+                  "%02x:%02x:%02x:%02x:%02x:%02x",
+                  static_cast<unsigned>((address >> 40) & 0xff),
+                  static_cast<unsigned>((address >> 32) & 0xff),
+                  static_cast<unsigned>((address >> 24) & 0xff),
+                  static_cast<unsigned>((address >> 16) & 0xff),
+                  static_cast<unsigned>((address >> 8) & 0xff),
+                  static_cast<unsigned>(address & 0xff));
+    return text;
+}
+
+/**
+ * @param part a count
+ * @param total the total count
+ * @return @p part in percent of @p total
+ */
+double
+Percent(uint64_t part, uint64_t total)
+{
+    return total ? 100.0 * part / total : 0;
+}
+
+} // namespace
+
+void
+CaptureStatistics::Add(const PcapRecord& record)
+{
+    ++m_records;
+    RadiotapInfo radiotap;
+    MacInfo mac;
+    if (!ParseRadiotap(record.data, record.length, radiotap) ||
+        record.wireLength < radiotap.length ||
+        !ParseMacHeader(record.data + radiotap.length,
+                        record.length - radiotap.length,
+                        record.wireLength - radiotap.length,
+                        mac))
+    {
+        ++m_malformed;
+        return;
+    }
+
+    // The subframes of an A-MPDU share a reference number; the transmit and
+    // receive directions number their A-MPDUs independently
+    bool sameAmpdu = m_current.valid && radiotap.hasAmpdu && m_current.radiotap.hasAmpdu &&
+                     radiotap.ampduReference == m_current.radiotap.ampduReference &&
+                     radiotap.hasSignal == m_current.radiotap.hasSignal &&
+                     mac.transmitter == m_current.mac.transmitter;
+    if (!sameAmpdu)
+    {
+        if (m_current.valid)
+        {
+            ClosePpdu();
+        }
+        m_current.valid = true;
+        m_current.radiotap = radiotap;
+        m_current.mac = mac;
+        m_current.firstTimestamp = record.timestamp;
+        m_current.psduBytes = 0;
+        m_current.mpdus = 0;
+        m_current.mpduBytes = 0;
+        m_current.dataFrames = 0;
+        m_current.retries = 0;
+    }
+    else if (m_current.psduBytes % 4)
+    {
+        // Pad the previous subframe to a multiple of four bytes
+        m_current.psduBytes += 4 - m_current.psduBytes % 4;
+    }
+
+    m_current.lastTimestamp = record.timestamp;
+    m_current.psduBytes += mac.length + (radiotap.hasAmpdu ? 4 : 0);
+    m_current.mpduBytes += mac.length;
+    ++m_current.mpdus;
+    if (mac.kind == FrameKind::DATA || mac.kind == FrameKind::MANAGEMENT)
+    {
+        ++m_current.dataFrames;
+        m_current.retries += mac.retry;
+    }
+}
+
+void
+CaptureStatistics::Finish()
+{
+    if (m_current.valid)
+    {
+        ClosePpdu();
+    }
+}
+
+void
+CaptureStatistics::ClosePpdu()
+{
+    Ppdu& ppdu = m_current;
+    const MacInfo& mac = ppdu.mac;
+    uint64_t duration =
+        GetPreambleDuration(ppdu.radiotap) + GetPayloadDuration(ppdu.radiotap, ppdu.psduBytes);
+    if (ppdu.radiotap.hasSignal)
+    {
+        // Received frames are captured once received, at the end of the PPDU
+        ppdu.end = ppdu.lastTimestamp;
+        ppdu.start = ppdu.end > duration ? ppdu.end - duration : 0;
+    }
+    else
+    {
+        ppdu.start = ppdu.firstTimestamp;
+        ppdu.end = ppdu.start + duration;
+    }
+
+    bool response = mac.kind == FrameKind::CTS || mac.kind == FrameKind::ACK ||
+                    mac.kind == FrameKind::BLOCK_ACK;
+    bool answersPrevious = m_previous.valid && response && mac.receiver == m_previous.transmitter;
+    ppdu.transmitter = mac.transmitter;
+    if (ppdu.transmitter == 0 && answersPrevious)
+    {
+        ppdu.transmitter = m_previous.mac.receiver;
+    }
+    ppdu.solicitsResponse =
+        mac.kind == FrameKind::RTS || mac.kind == FrameKind::BLOCK_ACK_REQUEST ||
+        ((mac.kind == FrameKind::DATA || mac.kind == FrameKind::MANAGEMENT) &&
+         !IsGroupAddress(mac.receiver));
+
+    StationStatistics& station = m_stations[ppdu.transmitter];
+    station.frames += ppdu.mpdus;
+    station.bytes += ppdu.mpduBytes;
+    station.airtime += duration;
+    station.dataFrames += ppdu.dataFrames;
+    station.retries += ppdu.retries;
+    switch (mac.kind)
+    {
+    case FrameKind::RTS:
+        ++station.rts;
+        break;
+    case FrameKind::CTS:
+        ++station.cts;
+        break;
+    case FrameKind::ACK:
+        ++station.acks;
+        break;
+    case FrameKind::BLOCK_ACK_REQUEST:
+        ++station.blockAckRequests;
+        break;
+    case FrameKind::BLOCK_ACK:
+        ++station.blockAcks;
+        break;
+    default:
+        break;
+    }
+    if (ppdu.radiotap.hasAmpdu)
+    {
+        ++station.ampdus;
+        station.ampduSubframes += ppdu.mpdus;
+        ++m_ampdus;
+        m_ampduSubframes += ppdu.mpdus;
+        m_ampduBytes += ppdu.psduBytes;
+        m_maxAmpduSubframes = std::max(m_maxAmpduSubframes, ppdu.mpdus);
+        uint32_t bin = 0;
+        for (uint32_t n = ppdu.mpdus; n > 1 && bin < 7; n /= 2)
+        {
+            ++bin;
+        }
+        ++m_ampduHistogram[bin];
+    }
+
+    if (m_previous.valid)
+    {
+        uint64_t overlapStart = std::max(ppdu.start, m_previous.start);
+        uint64_t overlapEnd = std::min(ppdu.end, m_previous.end);
+        if (overlapEnd > overlapStart)
+        {
+            ++m_overlaps;
+            m_overlapTime += overlapEnd - overlapStart;
+        }
+        if (m_previous.solicitsResponse && !answersPrevious)
+        {
+            ++m_unanswered;
+            ++m_stations[m_previous.transmitter].unanswered;
+            if (ppdu.start > m_previous.start)
+            {
+                m_unansweredTime += ppdu.start - m_previous.start;
+            }
+        }
+    }
+
+    m_first = m_ppdus == 0 ? ppdu.start : std::min(m_first, ppdu.start);
+    m_last = std::max(m_last, ppdu.end);
+    ++m_ppdus;
+    m_previous = ppdu;
+    m_current.valid = false;
+}
+
+const std::unordered_map<uint64_t, StationStatistics>&
+CaptureStatistics::GetStations() const
+{
+    return m_stations;
+}
+
+void
+CaptureStatistics::Print(std::ostream& os) const
+{
+    uint64_t span = m_last > m_first ? m_last - m_first : 0;
+    os << "Records: " << m_records << " (" << m_malformed << " malformed), PPDUs: " << m_ppdus
+       << ", span: " << span / 1e9 << " s\n";
+
+    std::vector<std::pair<uint64_t, const StationStatistics*>> stations;
+    stations.reserve(m_stations.size());
+    for (const auto& [address, station] : m_stations)
+    {
+        stations.emplace_back(address, &station);
+    }
+    std::sort(stations.begin(), stations.end(), [](const auto& a, const auto& b) {
+        return a.second->airtime > b.second->airtime;
+    });
+
+    os << std::left << std::setw(18) << "station" << std::right << std::setw(9) << "frames"
+       << std::setw(12) << "bytes" << std::setw(12) << "airtime_ms" << std::setw(9)
+       << "airtime%" << std::setw(8) << "retry%" << std::setw(7) << "rts" << std::setw(7)
+       << "cts" << std::setw(7) << "ack" << std::setw(7) << "bar" << std::setw(7) << "ba"
+       << std::setw(8) << "ampdus" << std::setw(13) << "mpdus/ampdu" << std::setw(12)
+       << "unanswered"
+       << "\n";
+    os << std::fixed;
+    for (const auto& [address, station] : stations)
+    {
+        os << std::left << std::setw(18) << FormatAddress(address) << std::right << std::setw(9)
+           << station->frames << std::setw(12) << station->bytes << std::setw(12)
+           << std::setprecision(3) << station->airtime / 1e6 << std::setw(9)
+           << std::setprecision(2) << Percent(station->airtime, span) << std::setw(8)
+           << Percent(station->retries, station->dataFrames) << std::setw(7) << station->rts
+           << std::setw(7) << station->cts << std::setw(7) << station->acks << std::setw(7)
+           << station->blockAckRequests << std::setw(7) << station->blockAcks << std::setw(8)
+           << station->ampdus << std::setw(13)
+           << (station->ampdus ? static_cast<double>(station->ampduSubframes) / station->ampdus
+                               : 0.0)
+           << std::setw(12) << station->unanswered << "\n";
+    }
+
+    os << std::setprecision(3);
+    os << "Collision windows: " << m_overlaps << " overlapping PPDUs (" << m_overlapTime / 1e6
+       << " ms), " << m_unanswered << " unanswered PPDUs (" << m_unansweredTime / 1e6
+       << " ms), " << Percent(m_overlapTime + m_unansweredTime, span) << "% of the capture\n";
+    os << "A-MPDUs: " << m_ampdus;
+    if (m_ampdus)
+    {
+        os << ", mean " << static_cast<double>(m_ampduSubframes) / m_ampdus << " MPDUs / "
+           << static_cast<double>(m_ampduBytes) / m_ampdus << " bytes, max "
+           << m_maxAmpduSubframes << " MPDUs\n";
+        os << "A-MPDU sizes (MPDUs):";
+        for (uint32_t bin = 0; bin < 8; ++bin)
+        {
+            uint32_t low = 1U << bin;
+            os << " " << low;
+            if (bin == 7)
+            {
+                os << "+";
+            }
+            else if (low > 1)
+            {
+                os << "-" << 2 * low - 1;
+            }
+            os << ": " << m_ampduHistogram[bin];
+        }
+    }
+    os << "\n";
+    os.unsetf(std::ios_base::floatfield);
+}
+
+} // namespace ns3
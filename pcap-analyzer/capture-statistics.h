@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_CAPTURE_STATISTICS_H
+#define SCRATCH_CAPTURE_STATISTICS_H
+
+// Airtime and MAC statistics accumulated over the frames of a radiotap capture.
+
+#include "wifi-frame.h"
+
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+namespace ns3
+{
+
+struct PcapRecord;
+
+/// Counters of the frames transmitted by one station
+struct StationStatistics
+{
+    uint64_t frames{0};           //!< MPDUs
+    uint64_t bytes{0};            //!< MPDU bytes, FCS included
+    uint64_t airtime{0};          //!< Airtime of the PPDUs in nanoseconds
+    uint64_t dataFrames{0};       //!< Data and management MPDUs
+    uint64_t retries{0};          //!< Data and management MPDUs with the Retry bit set
+    uint64_t rts{0};              //!< RTS frames
+    uint64_t cts{0};              //!< CTS frames
+    uint64_t acks{0};             //!< ACK frames
+    uint64_t blockAckRequests{0}; //!< Block ack requests
+    uint64_t blockAcks{0};        //!< Block acks
+    uint64_t ampdus{0};           //!< A-MPDUs
+    uint64_t ampduSubframes{0};   //!< MPDUs carried in A-MPDUs
+    uint64_t unanswered{0};       //!< RTS, unicast data and BAR PPDUs without a response
+};
+
+/**
+ * Accumulates per-station statistics over the records of one capture, in
+ * capture order.
+ *
+ * MPDUs are grouped into PPDUs with the radiotap A-MPDU status field, and a
+ * PPDU is charged its preamble plus the symbols of its PSDU (4-byte delimiter
+ * and padding included for A-MPDU subframes), as computed from the radiotap
+ * rate, MCS, VHT or HE field. ns-3 stamps transmitted frames at the start of
+ * the PPDU and received frames (those with an antenna signal) at its end,
+ * which gives each PPDU a time interval.
+ *
+ * CTS and ACK frames carry no transmitter address; they are charged to the
+ * receiver of the previous PPDU when they answer it, and to the unknown
+ * station (address 0) otherwise.
+ *
+ * Collision windows are the periods where the medium was not used
+ * successfully, as seen by the capturing node:
+ *  - two PPDUs overlap in time (the window is the overlap);
+ *  - an RTS, a unicast data or management PPDU or a BAR is not followed by a
+ *    CTS, ACK or block ack addressed to its transmitter (the window runs from
+ *    the start of the PPDU to the start of the next one).
+ *
+ * Adding a record does not allocate, except the first time a station is seen.
+ */
+class CaptureStatistics
+{
+  public:
+    /**
+     * Add a record of a radiotap capture. Records that cannot be decoded are
+     * counted and skipped.
+     *
+     * @param record the record
+     */
+    void Add(const PcapRecord& record);
+
+    /**
+     * Close the last PPDU. Call it after the last record.
+     */
+    void Finish();
+
+    /**
+     * Print the report.
+     *
+     * @param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * @return the statistics per transmitter address
+     */
+    const std::unordered_map<uint64_t, StationStatistics>& GetStations() const;
+
+  private:
+    /// A PPDU being assembled from its MPDUs, or the previous complete PPDU
+    struct Ppdu
+    {
+        bool valid{false};            //!< Whether the PPDU holds at least one MPDU
+        RadiotapInfo radiotap;        //!< PHY parameters of the first MPDU
+        MacInfo mac;                  //!< MAC header of the first MPDU
+        uint64_t transmitter{0};      //!< Transmitter address, inferred for CTS and ACK
+        uint64_t firstTimestamp{0};   //!< Capture time of the first MPDU in nanoseconds
+        uint64_t lastTimestamp{0};    //!< Capture time of the last MPDU in nanoseconds
+        uint64_t start{0};            //!< Start of the PPDU in nanoseconds
+        uint64_t end{0};              //!< End of the PPDU in nanoseconds
+        uint32_t psduBytes{0};        //!< PSDU size, A-MPDU delimiters and padding included
+        uint32_t mpdus{0};            //!< Number of MPDUs
+        uint64_t mpduBytes{0};        //!< Bytes of the MPDUs, FCS included
+        uint32_t dataFrames{0};       //!< Data and management MPDUs
+        uint32_t retries{0};          //!< Data and management MPDUs with the Retry bit set
+        bool solicitsResponse{false}; //!< Whether a CTS, ACK or block ack is expected
+    };
+
+    /**
+     * Compute the timing of the current PPDU, charge it to its transmitter
+     * and update the collision windows.
+     */
+    void ClosePpdu();
+
+    std::unordered_map<uint64_t, StationStatistics> m_stations; //!< Per transmitter address
+    Ppdu m_current;                  //!< PPDU being assembled
+    Ppdu m_previous;                 //!< Last complete PPDU
+    uint64_t m_records{0};           //!< Records added
+    uint64_t m_malformed{0};         //!< Records that could not be decoded
+    uint64_t m_ppdus{0};             //!< Complete PPDUs
+    uint64_t m_first{0};             //!< Start of the first PPDU in nanoseconds
+    uint64_t m_last{0};              //!< End of the last PPDU in nanoseconds
+    uint64_t m_overlaps{0};          //!< Overlapping PPDU pairs
+    uint64_t m_overlapTime{0};       //!< Total overlap in nanoseconds
+    uint64_t m_unanswered{0};        //!< PPDUs left without the expected response
+    uint64_t m_unansweredTime{0};    //!< Total time lost to unanswered PPDUs in nanoseconds
+    uint64_t m_ampdus{0};            //!< A-MPDUs
+    uint64_t m_ampduSubframes{0};    //!< MPDUs carried in A-MPDUs
+    uint64_t m_ampduBytes{0};        //!< PSDU bytes of the A-MPDUs
+    uint32_t m_maxAmpduSubframes{0}; //!< Largest A-MPDU in MPDUs
+    uint32_t m_ampduHistogram[8]{};  //!< A-MPDUs by number of MPDUs: 1, 2-3, 4-7, ..., 128+
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_CAPTURE_STATISTICS_H */
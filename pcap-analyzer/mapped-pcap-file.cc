@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "mapped-pcap-file.h"
+
+#include "ns3/abort.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace ns3
+{
+
+namespace
+{
+
+constexpr std::size_t GLOBAL_HEADER_SIZE = 24;      //!< Size of the pcap file header
+constexpr std::size_t RECORD_HEADER_SIZE = 16;      //!< Size of a pcap record header
+constexpr uint32_t MAGIC_MICROSECONDS = 0xa1b2c3d4; //!< Magic number, microsecond timestamps
+constexpr uint32_t MAGIC_NANOSECONDS = 0xa1b23c4d;  //!< Magic number, nanosecond timestamps
+
+} // namespace
+
+MappedPcapFile::MappedPcapFile(const std::string& filename)
+    : m_filename(filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    NS_ABORT_MSG_IF(fd < 0, "Cannot open " << filename << ": " << std::strerror(errno));
+    struct stat info;
+    NS_ABORT_MSG_IF(fstat(fd, &info) != 0,
+                    "Cannot stat " << filename << ": " << std::strerror(errno));
+    m_size = info.st_size;
+    NS_ABORT_MSG_IF(m_size < GLOBAL_HEADER_SIZE, filename << " is not a pcap file");
+
+    void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(mapping == MAP_FAILED,
+                    "Cannot map " << filename << ": " << std::strerror(errno));
+    // The records are read once, front to back
+    madvise(mapping, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const uint8_t*>(mapping);
+
+    uint32_t magic;
+    std::memcpy(&magic, m_data, sizeof(magic));
+    if (magic == MAGIC_MICROSECONDS || magic == MAGIC_NANOSECONDS)
+    {
+        m_swapped = false;
+    }
+    else if (__builtin_bswap32(magic) == MAGIC_MICROSECONDS ||
+             __builtin_bswap32(magic) == MAGIC_NANOSECONDS)
+    {
+        m_swapped = true;
+        magic = __builtin_bswap32(magic);
+    }
+    else
+    {
+        NS_ABORT_MSG(filename << " is not a pcap file (pcapng is not supported)");
+    }
+    m_nanoseconds = magic == MAGIC_NANOSECONDS;
+    m_dataLinkType = Read32(m_data + 20);
+    m_offset = GLOBAL_HEADER_SIZE;
+}
+
+MappedPcapFile::~MappedPcapFile()
+{
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+}
+
+uint32_t
+MappedPcapFile::GetDataLinkType() const
+{
+    return m_dataLinkType;
+}
+
+std::size_t
+MappedPcapFile::GetSize() const
+{
+    return m_size;
+}
+
+uint32_t
+MappedPcapFile::Read32(const uint8_t* p) const
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return m_swapped ? __builtin_bswap32(v) : v;
+}
+
+bool
+MappedPcapFile::Next(PcapRecord& record)
+{
+    if (m_size - m_offset < RECORD_HEADER_SIZE)
+    {
+        return false;
+    }
+    const uint8_t* header = m_data + m_offset;
+    uint32_t length = Read32(header + 8);
+    if (m_size - m_offset - RECORD_HEADER_SIZE < length)
+    {
+        return false;
+    }
+    uint64_t fraction = Read32(header + 4);
+    record.timestamp =
+        Read32(header) * 1000000000ULL + (m_nanoseconds ? fraction : fraction * 1000);
+    record.length = length;
+    record.wireLength = Read32(header + 12);
+    record.data = header + RECORD_HEADER_SIZE;
+    m_offset += RECORD_HEADER_SIZE + length;
+    return true;
+}
+
+void
+MappedPcapFile::Rewind()
+{
+    m_offset = GLOBAL_HEADER_SIZE;
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_MAPPED_PCAP_FILE_H
+#define SCRATCH_MAPPED_PCAP_FILE_H
+
+// Read-only, memory-mapped view of a classic (libpcap) capture file.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * One record of a capture. The data points into the mapping and stays valid
+ * as long as the MappedPcapFile it came from.
+ */
+struct PcapRecord
+{
+    uint64_t timestamp;  //!< Capture time in nanoseconds
+    uint32_t length;     //!< Captured length
+    uint32_t wireLength; //!< Original length on the wire
+    const uint8_t* data; //!< Captured bytes
+};
+
+/**
+ * Maps a pcap file into memory and walks its records in place. Both byte
+ * orders and both the microsecond and nanosecond timestamp variants are
+ * accepted; pcapng is not.
+ *
+ *     MappedPcapFile file(name);
+ *     PcapRecord record;
+ *     while (file.Next(record))
+ *     {
+ *         ...
+ *     }
+ */
+class MappedPcapFile
+{
+  public:
+    /**
+     * Map a file and check its global header. Aborts if the file cannot be
+     * mapped or is not a pcap file.
+     *
+     * @param filename the capture file
+     */
+    explicit MappedPcapFile(const std::string& filename);
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedPcapFile();
+
+    MappedPcapFile(const MappedPcapFile&) = delete;
+    MappedPcapFile& operator=(const MappedPcapFile&) = delete;
+
+    /**
+     * @return the link-layer header type of the capture (127 for radiotap)
+     */
+    uint32_t GetDataLinkType() const;
+
+    /**
+     * @return the size of the file in bytes
+     */
+    std::size_t GetSize() const;
+
+    /**
+     * Read the next record. A truncated last record ends the walk.
+     *
+     * @param record receives the record
+     * @return false at the end of the file
+     */
+    bool Next(PcapRecord& record);
+
+    /**
+     * Restart the walk at the first record.
+     */
+    void Rewind();
+
+  private:
+    /**
+     * @param p pointer into the mapping
+     * @return the 32-bit field at @p p in the byte order of the file
+     */
+    uint32_t Read32(const uint8_t* p) const;
+
+    std::string m_filename;         //!< File name, for error messages
+    const uint8_t* m_data{nullptr}; //!< Start of the mapping
+    std::size_t m_size{0};          //!< Size of the mapping
+    std::size_t m_offset{0};        //!< Offset of the next record
+    bool m_swapped{false};          //!< Whether the file byte order differs from the host
+    bool m_nanoseconds{false};      //!< Whether the timestamps are in nanoseconds
+    uint32_t m_dataLinkType{0};     //!< Link-layer header type
+};
+
+} // namespace ns3
+
+#endif /* SCRATCH_MAPPED_PCAP_FILE_H */
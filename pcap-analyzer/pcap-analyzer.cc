@@ -0,0 +1,148 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Airtime and MAC statistics of radiotap captures written by the wifi
+// scenarios (e.g. q3 with pcap enabled).
+//
+// Every capture is memory-mapped and its records are decoded in place; the
+// captures are analyzed in parallel, one per thread, and the reports are
+// printed in the order of the command line. Captures of another link type
+// than radiotap are reported and skipped, and the exit code is then 1.
+//
+//   ./ns3 run "pcap-analyzer pcaps/q3/q3-3_RTS_Enabled/module2-AccessPoint-0-0.pcap"
+//   ./ns3 run "pcap-analyzer --jobs=4 pcaps/q3/*/module2-AccessPoint-0-0.pcap"
+
+#include "capture-statistics.h"
+#include "mapped-pcap-file.h"
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+constexpr uint32_t DLT_IEEE802_11_RADIO = 127; //!< Radiotap link-layer header type
+
+/// Outcome of the analysis of one capture
+struct CaptureReport
+{
+    bool analyzed{false}; //!< Whether the capture was analyzed, false if skipped
+    std::string text;     //!< Report, or why the capture was skipped
+};
+
+/**
+ * Analyze one capture. Runs on a worker thread, so a capture of another link
+ * type is reported instead of aborting the other analyses.
+ *
+ * @param filename the capture file
+ * @return the report
+ */
+CaptureReport
+AnalyzeCapture(const std::string& filename)
+{
+    auto begin = std::chrono::steady_clock::now();
+    MappedPcapFile file(filename);
+    if (file.GetDataLinkType() != DLT_IEEE802_11_RADIO)
+    {
+        std::ostringstream reason;
+        reason << filename << " skipped: not a radiotap capture (link type "
+               << file.GetDataLinkType() << ")";
+        return {false, reason.str()};
+    }
+
+    CaptureStatistics statistics;
+    PcapRecord record;
+    while (file.Next(record))
+    {
+        statistics.Add(record);
+    }
+    statistics.Finish();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::ostringstream report;
+    report << "== " << filename << " (" << file.GetSize() / 1e6 << " MB in "
+           << elapsed.count() << " s)\n";
+    statistics.Print(report);
+    return {true, report.str()};
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string files; /* Comma separated capture files */
+    unsigned jobs = 0; /* Concurrent analyses, 0 for one per core */
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Report per-station airtime, control frame counts, retry rates, A-MPDU sizes\n"
+              "and collision windows of radiotap pcap files, given as arguments or --files.");
+    cmd.AddValue("files", "Comma separated capture files, in addition to the arguments", files);
+    cmd.AddValue("jobs", "Number of captures analyzed concurrently (0 for one per core)", jobs);
+    cmd.Parse(argc, argv);
+
+    std::vector<std::string> filenames;
+    for (std::size_t i = 0; i < cmd.GetNExtraNonOptions(); ++i)
+    {
+        filenames.push_back(cmd.GetExtraNonOption(i));
+    }
+    std::istringstream list(files);
+    for (std::string name; std::getline(list, name, ',');)
+    {
+        if (!name.empty())
+        {
+            filenames.push_back(name);
+        }
+    }
+    NS_ABORT_MSG_IF(filenames.empty(), "No capture file given");
+
+    if (jobs == 0)
+    {
+        jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+    jobs = std::min<std::size_t>(jobs, filenames.size());
+
+    std::vector<CaptureReport> reports(filenames.size());
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < jobs; ++i)
+    {
+        workers.emplace_back([&]() {
+            for (std::size_t file = next++; file < filenames.size(); file = next++)
+            {
+                reports[file] = AnalyzeCapture(filenames[file]);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    int status = 0;
+    for (const auto& report : reports)
+    {
+        if (report.analyzed)
+        {
+            std::cout << report.text << "\n";
+        }
+        else
+        {
+            std::cerr << report.text << "\n";
+            status = 1;
+        }
+    }
+    return status;
+}
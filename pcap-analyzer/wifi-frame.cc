@@ -0,0 +1,354 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "wifi-frame.h"
+
+namespace ns3
+{
+
+namespace
+{
+
+/// Alignment and size of a radiotap field
+struct RadiotapField
+{
+    uint8_t align; //!< Required alignment from the start of the header
+    uint8_t size;  //!< Size in bytes
+};
+
+/// Radiotap fields 0 to 27, indexed by their bit in the present word
+constexpr RadiotapField RADIOTAP_FIELDS[] = {
+    {8, 8},  // TSFT
+    {1, 1},  // Flags
+    {1, 1},  // Rate
+    {2, 4},  // Channel
+    {1, 2},  // FHSS
+    {1, 1},  // Antenna signal (dBm)
+    {1, 1},  // Antenna noise (dBm)
+    {2, 2},  // Lock quality
+    {2, 2},  // TX attenuation
+    {2, 2},  // TX attenuation (dB)
+    {1, 1},  // TX power (dBm)
+    {1, 1},  // Antenna
+    {1, 1},  // Antenna signal (dB)
+    {1, 1},  // Antenna noise (dB)
+    {2, 2},  // RX flags
+    {2, 2},  // TX flags
+    {1, 1},  // RTS retries
+    {1, 1},  // Data retries
+    {4, 8},  // XChannel
+    {1, 3},  // MCS
+    {4, 8},  // A-MPDU status
+    {2, 12}, // VHT
+    {8, 12}, // Timestamp
+    {2, 12}, // HE
+    {2, 12}, // HE-MU
+    {2, 6},  // HE-MU other user
+    {1, 1},  // Zero-length PSDU
+    {2, 4},  // L-SIG
+};
+
+/// Number of radiotap fields with a known layout
+constexpr uint32_t RADIOTAP_KNOWN_FIELDS = sizeof(RADIOTAP_FIELDS) / sizeof(RADIOTAP_FIELDS[0]);
+/// Bit of a present word announcing another present word
+constexpr uint32_t RADIOTAP_EXTENDED = 1U << 31;
+
+/**
+ * Data bits per OFDM symbol for one spatial stream and one subcarrier, times
+ * six, per MCS index (BPSK 1/2 to 1024-QAM 5/6).
+ */
+constexpr uint32_t BITS_PER_SUBCARRIER_X6[] = {3, 6, 9, 12, 18, 24, 27, 30, 36, 40, 45, 50};
+
+/**
+ * @param p pointer to a little-endian 16-bit field
+ * @return the field value
+ */
+uint16_t
+Read16(const uint8_t* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+/**
+ * @param p pointer to a little-endian 32-bit field
+ * @return the field value
+ */
+uint32_t
+Read32(const uint8_t* p)
+{
+    return Read16(p) | (static_cast<uint32_t>(Read16(p + 2)) << 16);
+}
+
+/**
+ * @param p pointer to a MAC address
+ * @return the address packed in an integer
+ */
+uint64_t
+ReadAddress(const uint8_t* p)
+{
+    uint64_t address = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        address = (address << 8) | p[i];
+    }
+    return address;
+}
+
+/**
+ * @param phy the PHY of the frame
+ * @param bandwidth the channel width in MHz
+ * @return the number of data subcarriers
+ */
+uint32_t
+GetDataSubcarriers(FramePhy phy, uint16_t bandwidth)
+{
+    if (phy == FramePhy::HE)
+    {
+        return bandwidth >= 160 ? 1960 : bandwidth >= 80 ? 980 : bandwidth >= 40 ? 468 : 234;
+    }
+    return bandwidth >= 160 ? 468 : bandwidth >= 80 ? 234 : bandwidth >= 40 ? 108 : 52;
+}
+
+/**
+ * @param nss the number of spatial streams
+ * @return the number of long training fields in an HT/VHT/HE preamble
+ */
+uint32_t
+GetTrainingFields(uint8_t nss)
+{
+    return nss == 3 ? 4 : nss > 4 ? 8 : nss;
+}
+
+} // namespace
+
+bool
+ParseRadiotap(const uint8_t* data, uint32_t length, RadiotapInfo& info)
+{
+    info = RadiotapInfo();
+    if (length < 8 || data[0] != 0)
+    {
+        return false;
+    }
+    info.length = Read16(data + 2);
+    if (info.length > length)
+    {
+        return false;
+    }
+
+    // Skip the extended present words; only the fields of the first word are decoded
+    uint32_t present = Read32(data + 4);
+    uint32_t offset = 8;
+    for (uint32_t word = present; word & RADIOTAP_EXTENDED; word = Read32(data + offset - 4))
+    {
+        offset += 4;
+        if (offset > info.length)
+        {
+            return false;
+        }
+    }
+
+    bool hasRate = false;
+    for (uint32_t bit = 0; bit < RADIOTAP_KNOWN_FIELDS; ++bit)
+    {
+        if (!(present & (1U << bit)))
+        {
+            continue;
+        }
+        const RadiotapField& field = RADIOTAP_FIELDS[bit];
+        offset = (offset + field.align - 1) & ~static_cast<uint32_t>(field.align - 1);
+        if (offset + field.size > info.length)
+        {
+            return false;
+        }
+        const uint8_t* p = data + offset;
+        switch (bit)
+        {
+        case 1:
+            info.flags = p[0];
+            break;
+        case 2:
+            info.rate = p[0];
+            hasRate = true;
+            break;
+        case 3:
+            info.frequency = Read16(p);
+            info.channelFlags = Read16(p + 2);
+            break;
+        case 5:
+            info.hasSignal = true;
+            info.signal = static_cast<int8_t>(p[0]);
+            break;
+        case 6:
+            info.noise = static_cast<int8_t>(p[0]);
+            break;
+        case 19:
+            info.phy = FramePhy::HT;
+            info.mcs = p[2];
+            info.nss = p[2] / 8 + 1;
+            info.bandwidth = (p[1] & 0x03) == 1 ? 40 : 20;
+            info.guardInterval = (p[1] & 0x04) ? 400 : 800;
+            break;
+        case 20:
+            info.hasAmpdu = true;
+            info.ampduReference = Read32(p);
+            info.ampduLast = (Read16(p + 4) & 0x000c) == 0x000c;
+            break;
+        case 21:
+            info.phy = FramePhy::VHT;
+            info.guardInterval = (p[2] & 0x04) ? 400 : 800;
+            // Codes 1-3 are 40 MHz, 4-10 80 MHz and 11-25 160 MHz channels or sub-channels
+            info.bandwidth = p[3] == 0 ? 20 : p[3] < 4 ? 40 : p[3] < 11 ? 80 : 160;
+            info.mcs = p[4] >> 4;
+            info.nss = (p[4] & 0x0f) ? (p[4] & 0x0f) : 1;
+            break;
+        case 23: {
+            static constexpr uint16_t HE_WIDTHS[] = {20, 40, 80, 160};
+            static constexpr uint16_t HE_GUARD_INTERVALS[] = {800, 1600, 3200, 3200};
+            uint16_t data3 = Read16(p + 4);
+            uint16_t data5 = Read16(p + 8);
+            uint16_t data6 = Read16(p + 10);
+            info.phy = FramePhy::HE;
+            info.mcs = (data3 >> 8) & 0x0f;
+            info.bandwidth = (data5 & 0x0f) < 4 ? HE_WIDTHS[data5 & 0x0f] : 20;
+            info.guardInterval = HE_GUARD_INTERVALS[(data5 >> 4) & 0x03];
+            info.nss = (data6 & 0x0f) ? (data6 & 0x0f) : 1;
+            break;
+        }
+        default:
+            break;
+        }
+        offset += field.size;
+    }
+
+    if (info.phy == FramePhy::OFDM && hasRate)
+    {
+        bool dsssRate = info.rate == 2 || info.rate == 4 || info.rate == 11 || info.rate == 22;
+        if (dsssRate || (info.channelFlags & 0x0020))
+        {
+            info.phy = FramePhy::DSSS;
+        }
+    }
+    return true;
+}
+
+bool
+ParseMacHeader(const uint8_t* data, uint32_t length, uint32_t wireLength, MacInfo& info)
+{
+    info = MacInfo();
+    if (length < 10)
+    {
+        return false;
+    }
+    uint8_t type = (data[0] >> 2) & 0x03;
+    uint8_t subtype = data[0] >> 4;
+    info.retry = data[1] & 0x08;
+    info.receiver = ReadAddress(data + 4);
+    info.length = wireLength;
+
+    switch (type)
+    {
+    case 0:
+        info.kind = FrameKind::MANAGEMENT;
+        break;
+    case 2:
+        info.kind = FrameKind::DATA;
+        break;
+    case 1:
+        switch (subtype)
+        {
+        case 8:
+            info.kind = FrameKind::BLOCK_ACK_REQUEST;
+            break;
+        case 9:
+            info.kind = FrameKind::BLOCK_ACK;
+            break;
+        case 11:
+            info.kind = FrameKind::RTS;
+            break;
+        case 12:
+            info.kind = FrameKind::CTS;
+            break;
+        case 13:
+            info.kind = FrameKind::ACK;
+            break;
+        default:
+            info.kind = FrameKind::OTHER_CONTROL;
+            break;
+        }
+        break;
+    default:
+        info.kind = FrameKind::OTHER_CONTROL;
+        break;
+    }
+
+    // CTS and ACK frames only carry the receiver address
+    if (info.kind != FrameKind::CTS && info.kind != FrameKind::ACK)
+    {
+        if (length < 16)
+        {
+            return false;
+        }
+        info.transmitter = ReadAddress(data + 10);
+    }
+    return true;
+}
+
+uint64_t
+GetPayloadDuration(const RadiotapInfo& radiotap, uint32_t bytes)
+{
+    // SERVICE field, PSDU and tail bits
+    uint64_t bits = 16 + 8ULL * bytes + 6;
+    switch (radiotap.phy)
+    {
+    case FramePhy::DSSS:
+        // No SERVICE field or tail; the rate is in units of 500 kbit/s
+        return radiotap.rate ? (8ULL * bytes * 2000 + radiotap.rate - 1) / radiotap.rate : 0;
+    case FramePhy::OFDM: {
+        uint64_t bitsPerSymbol = 2ULL * radiotap.rate;
+        return bitsPerSymbol ? (bits + bitsPerSymbol - 1) / bitsPerSymbol * 4000 : 0;
+    }
+    case FramePhy::HT:
+    case FramePhy::VHT:
+    case FramePhy::HE: {
+        uint8_t mcs = radiotap.phy == FramePhy::HT ? radiotap.mcs % 8 : radiotap.mcs;
+        if (mcs >= sizeof(BITS_PER_SUBCARRIER_X6) / sizeof(BITS_PER_SUBCARRIER_X6[0]))
+        {
+            return 0;
+        }
+        uint64_t bitsPerSymbol = GetDataSubcarriers(radiotap.phy, radiotap.bandwidth) *
+                                 BITS_PER_SUBCARRIER_X6[mcs] * radiotap.nss / 6;
+        uint64_t symbol = (radiotap.phy == FramePhy::HE ? 12800 : 3200) + radiotap.guardInterval;
+        return (bits + bitsPerSymbol - 1) / bitsPerSymbol * symbol;
+    }
+    }
+    return 0;
+}
+
+uint64_t
+GetPreambleDuration(const RadiotapInfo& radiotap)
+{
+    // Legacy short and long training fields and SIGNAL field
+    constexpr uint64_t LEGACY = 20000;
+    uint64_t trainingFields = GetTrainingFields(radiotap.nss);
+    switch (radiotap.phy)
+    {
+    case FramePhy::DSSS:
+        return 192000;
+    case FramePhy::OFDM:
+        // 2.4 GHz OFDM frames end with a 6 us signal extension
+        return LEGACY + ((radiotap.channelFlags & 0x0080) ? 6000 : 0);
+    case FramePhy::HT:
+        // HT-SIG, HT-STF, HT-LTFs
+        return LEGACY + 8000 + 4000 + 4000 * trainingFields;
+    case FramePhy::VHT:
+        // VHT-SIG-A, VHT-STF, VHT-LTFs, VHT-SIG-B
+        return LEGACY + 8000 + 4000 + 4000 * trainingFields + 4000;
+    case FramePhy::HE:
+        // RL-SIG, HE-SIG-A, HE-STF, 2x HE-LTFs with a 1.6 us guard interval
+        return LEGACY + 4000 + 8000 + 4000 + 8000 * trainingFields;
+    }
+    return 0;
+}
+
+} // namespace ns3
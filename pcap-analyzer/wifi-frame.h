@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_WIFI_FRAME_H
+#define SCRATCH_WIFI_FRAME_H
+
+// Radiotap and 802.11 MAC header decoding for captured frames.
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/// PHY of a captured frame, from the radiotap fields present
+enum class FramePhy : uint8_t
+{
+    DSSS, //!< 802.11b rates (1, 2, 5.5, 11 Mbit/s)
+    OFDM, //!< 802.11a/g rates
+    HT,   //!< 802.11n (radiotap MCS field)
+    VHT,  //!< 802.11ac (radiotap VHT field)
+    HE    //!< 802.11ax (radiotap HE field)
+};
+
+/**
+ * The fields of a radiotap header used by the analyzer. Fields that are not
+ * present keep their default value.
+ */
+struct RadiotapInfo
+{
+    uint16_t length{0};           //!< Length of the radiotap header
+    uint8_t flags{0};             //!< Flags field (0x10: frame ends with an FCS)
+    uint16_t frequency{0};        //!< Channel frequency in MHz
+    uint16_t channelFlags{0};     //!< Channel flags (0x0080: 2.4 GHz)
+    bool hasSignal{false};        //!< Whether an antenna signal is present (received frame)
+    int8_t signal{0};             //!< Antenna signal in dBm
+    int8_t noise{0};              //!< Antenna noise in dBm
+    FramePhy phy{FramePhy::OFDM}; //!< PHY of the frame
+    uint16_t rate{0};             //!< Legacy rate in units of 500 kbit/s
+    uint8_t mcs{0};               //!< MCS index (HT: 0-31, VHT/HE: 0-11)
+    uint8_t nss{1};               //!< Number of spatial streams
+    uint16_t bandwidth{20};       //!< Channel width in MHz
+    uint16_t guardInterval{800};  //!< Guard interval in nanoseconds
+    bool hasAmpdu{false};         //!< Whether the frame is an A-MPDU subframe
+    uint32_t ampduReference{0};   //!< A-MPDU reference number
+    bool ampduLast{false};        //!< Whether the subframe is known to be the last one
+};
+
+/// Type of an 802.11 frame, from the frame control field
+enum class FrameKind : uint8_t
+{
+    MANAGEMENT,        //!< Management frame (beacon, association, action...)
+    DATA,              //!< Data or QoS data frame, including null frames
+    RTS,               //!< Request to send
+    CTS,               //!< Clear to send
+    ACK,               //!< Normal acknowledgment
+    BLOCK_ACK_REQUEST, //!< Block ack request
+    BLOCK_ACK,         //!< Block ack
+    OTHER_CONTROL      //!< Any other control frame (CF-End, trigger...)
+};
+
+/**
+ * The fields of an 802.11 MAC header used by the analyzer. Addresses are
+ * packed in the low 48 bits of an integer, first octet most significant,
+ * and are zero when the frame does not carry them.
+ */
+struct MacInfo
+{
+    FrameKind kind{FrameKind::OTHER_CONTROL}; //!< Frame type
+    bool retry{false};                        //!< Retry bit
+    uint64_t receiver{0};                     //!< Address 1 (receiver)
+    uint64_t transmitter{0};                  //!< Address 2 (transmitter)
+    uint32_t length{0};                       //!< MPDU length, FCS included
+};
+
+/**
+ * Decode the radiotap header at the start of a captured frame.
+ *
+ * @param data the captured bytes
+ * @param length the captured length
+ * @param info receives the decoded fields
+ * @return false if the header is malformed or truncated
+ */
+bool ParseRadiotap(const uint8_t* data, uint32_t length, RadiotapInfo& info);
+
+/**
+ * Decode the 802.11 MAC header that follows the radiotap header.
+ *
+ * @param data the start of the MAC header
+ * @param length the captured length from @p data
+ * @param wireLength the original length from @p data, used as MPDU length
+ * @param info receives the decoded fields
+ * @return false if the header is truncated
+ */
+bool ParseMacHeader(const uint8_t* data, uint32_t length, uint32_t wireLength, MacInfo& info);
+
+/**
+ * Compute the duration of the data symbols carrying @p bytes, without the
+ * preamble, rounded up to a whole number of symbols.
+ *
+ * @param radiotap the PHY parameters of the frame
+ * @param bytes the PSDU size in bytes
+ * @return the duration in nanoseconds
+ */
+uint64_t GetPayloadDuration(const RadiotapInfo& radiotap, uint32_t bytes);
+
+/**
+ * @param radiotap the PHY parameters of the frame
+ * @return the duration of the PHY preamble and headers in nanoseconds
+ */
+uint64_t GetPreambleDuration(const RadiotapInfo& radiotap);
+
+} // namespace ns3
+
+#endif /* SCRATCH_WIFI_FRAME_H */
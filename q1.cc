@@ -2,6 +2,11 @@
  * SPDX-License-Identifier: GPL-2.0-only
  */
 
+#include "common/echo-load-client.h"
+#include "common/latency-histogram.h"
+#include "common/profiling-simulator-impl.h"
+#include "common/scenario-profile.h"
+
 #include "ns3/applications-module.h"
 #include "ns3/core-module.h"
 #include "ns3/internet-module.h"
@@ -32,19 +37,71 @@ NS_LOG_COMPONENT_DEFINE("FirstScriptExample");
 int
 main(int argc, char* argv[])
 {
+    ScenarioProfile profile;
+    bool pcapTracing = true;               /* PCAP Tracing is enabled or not. */
+    bool profiling = false;                /* Print the setup and run time and the event count. */
+    bool profileEvents = false;            /* Time the events of every callback type. */
+    std::string linkRate = "1Mbps";        /* Data rate of the point-to-point link. */
+    std::string linkDelay = "10ms";        /* Delay of the point-to-point link. */
+    double simulationTime = 10;            /* Time in seconds at which the applications stop. */
+    bool benchmark = false;                /* Load the link with echo flows and report the RTT. */
+    uint32_t flows = 1;                    /* Concurrent echo flows in benchmark mode. */
+    uint32_t packetSize = 1024;            /* UDP payload size of the echoes. */
+    std::string sendRate;                  /* Offered load per flow, empty to fill the link. */
+    std::string schedule = "back-to-back"; /* Send schedule: back-to-back or poisson. */
+
     CommandLine cmd(__FILE__);
+    cmd.AddValue("pcap", "Enable/disable PCAP Tracing", pcapTracing);
+    cmd.AddValue("profile", "Print the setup and run time and the number of events", profiling);
+    cmd.AddValue("profileEvents",
+                 "Time every event and report the most expensive callback types at the end, "
+                 "with a folded stack file (see ns3::ProfilingSimulatorImpl)",
+                 profileEvents);
+    cmd.AddValue("linkRate", "Data rate of the point-to-point link", linkRate);
+    cmd.AddValue("linkDelay", "Delay of the point-to-point link", linkDelay);
+    cmd.AddValue("simulationTime",
+                 "Time in seconds at which the applications stop",
+                 simulationTime);
+    cmd.AddValue("benchmark",
+                 "Replace the logged echo client by flows of EchoLoadClient and report the "
+                 "round trip time percentiles and the goodput",
+                 benchmark);
+    cmd.AddValue("flows", "Number of concurrent echo flows in benchmark mode", flows);
+    cmd.AddValue("packetSize", "UDP payload size in bytes of the echoes", packetSize);
+    cmd.AddValue("sendRate",
+                 "Offered load of each flow in benchmark mode (UDP payload), by default the "
+                 "flows together fill the link",
+                 sendRate);
+    cmd.AddValue("schedule",
+                 "Send schedule of the benchmark flows: back-to-back (constant interval) or "
+                 "poisson (exponential intervals of the same mean)",
+                 schedule);
     cmd.Parse(argc, argv);
+    NS_ABORT_MSG_UNLESS(schedule == "back-to-back" || schedule == "poisson",
+                        "Unknown schedule '" << schedule << "'");
+    NS_ABORT_MSG_IF(benchmark && flows == 0, "At least one flow is needed");
+    NS_ABORT_MSG_IF(simulationTime <= 2, "The clients start at 2 s");
+
+    if (profileEvents)
+    {
+        // Before the first use of the simulator, which creates the implementation
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(ProfilingSimulatorImpl::GetTypeId().GetName()));
+    }
 
     Time::SetResolution(Time::NS);
-    LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
-    LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
+    if (!benchmark)
+    {
+        LogComponentEnable("UdpEchoClientApplication", LOG_LEVEL_INFO);
+        LogComponentEnable("UdpEchoServerApplication", LOG_LEVEL_INFO);
+    }
 
     NodeContainer nodes;
     nodes.Create(2);
 
     PointToPointHelper pointToPoint;
-    pointToPoint.SetDeviceAttribute("DataRate", StringValue("1Mbps"));
-    pointToPoint.SetChannelAttribute("Delay", StringValue("10ms"));
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue(linkRate));
+    pointToPoint.SetChannelAttribute("Delay", StringValue(linkDelay));
 
     NetDeviceContainer devices;
     devices = pointToPoint.Install(nodes);
@@ -61,19 +118,76 @@ main(int argc, char* argv[])
 
     ApplicationContainer serverApps = echoServer.Install(nodes.Get(1));
     serverApps.Start(Seconds(1));
-    serverApps.Stop(Seconds(10));
-
-    UdpEchoClientHelper echoClient(interfaces.GetAddress(1), 6610);
-    echoClient.SetAttribute("MaxPackets", UintegerValue(1000));
-    echoClient.SetAttribute("Interval", TimeValue(Seconds(2)));
-    echoClient.SetAttribute("PacketSize", UintegerValue(1024));
-
-    ApplicationContainer clientApps = echoClient.Install(nodes.Get(0));
-    clientApps.Start(Seconds(2));
-    clientApps.Stop(Seconds(10));
-
-    pointToPoint.EnablePcapAll("q1");
+    serverApps.Stop(Seconds(simulationTime));
+
+    std::vector<Ptr<EchoLoadClient>> loadClients;
+    if (benchmark)
+    {
+        // By default the flows send back to back at the link rate, counting
+        // the UDP, IPv4 and PPP headers
+        Time interval = sendRate.empty()
+                            ? DataRate(linkRate).CalculateBytesTxTime(packetSize + 30) * flows
+                            : DataRate(sendRate).CalculateBytesTxTime(packetSize);
+        for (uint32_t i = 0; i < flows; ++i)
+        {
+            auto client = CreateObject<EchoLoadClient>();
+            client->SetAttribute("Remote",
+                                 AddressValue(InetSocketAddress(interfaces.GetAddress(1), 6610)));
+            client->SetAttribute("PacketSize", UintegerValue(packetSize));
+            client->SetAttribute("Interval", TimeValue(interval));
+            client->SetAttribute("Poisson", BooleanValue(schedule == "poisson"));
+            client->SetStartTime(Seconds(2));
+            client->SetStopTime(Seconds(simulationTime));
+            nodes.Get(0)->AddApplication(client);
+            loadClients.push_back(client);
+        }
+    }
+    else
+    {
+        UdpEchoClientHelper echoClient(interfaces.GetAddress(1), 6610);
+        echoClient.SetAttribute("MaxPackets", UintegerValue(1000));
+        echoClient.SetAttribute("Interval", TimeValue(Seconds(2)));
+        echoClient.SetAttribute("PacketSize", UintegerValue(packetSize));
+
+        ApplicationContainer clientApps = echoClient.Install(nodes.Get(0));
+        clientApps.Start(Seconds(2));
+        clientApps.Stop(Seconds(simulationTime));
+    }
+
+    if (pcapTracing)
+    {
+        pointToPoint.EnablePcapAll("q1");
+    }
+    profile.EndSetup();
     Simulator::Run();
+    profile.EndRun();
+    if (benchmark)
+    {
+        LatencyHistogram latencies;
+        uint64_t sent = 0;
+        uint64_t rxBytes = 0;
+        for (const auto& client : loadClients)
+        {
+            latencies.Merge(client->GetLatencies());
+            sent += client->GetNSent();
+            rxBytes += client->GetRxBytes();
+        }
+        uint64_t received = latencies.GetCount();
+        std::cout << "Echo benchmark: " << flows << " flows (" << schedule << "), " << sent
+                  << " packets sent, " << received << " echoed ("
+                  << (sent > 0 ? 100.0 * (sent - received) / sent : 0) << "% lost)" << std::endl;
+        std::cout << "RTT (ms): mean " << latencies.GetMean().GetSeconds() * 1e3 << ", p50 "
+                  << latencies.GetQuantile(0.5).GetSeconds() * 1e3 << ", p99 "
+                  << latencies.GetQuantile(0.99).GetSeconds() * 1e3 << ", p99.9 "
+                  << latencies.GetQuantile(0.999).GetSeconds() * 1e3 << ", max "
+                  << latencies.GetMax().GetSeconds() * 1e3 << std::endl;
+        std::cout << "Goodput: " << rxBytes * 8 / ((simulationTime - 2) * 1e6) << " Mbps"
+                  << std::endl;
+    }
+    if (profiling)
+    {
+        profile.Report(std::cout);
+    }
     Simulator::Destroy();
     return 0;
 }
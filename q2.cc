@@ -41,8 +41,29 @@
  * Date: September 14, 2025
  */
 
+#include "common/capture-writer.h"
+#include "common/convergence-monitor.h"
+#include "common/distance-sweep.h"
+#include "common/flow-delay-probe.h"
+#include "common/profiling-simulator-impl.h"
+#include "common/propagation-cache.h"
+#include "common/radix-heap-scheduler.h"
+#include "common/replication.h"
+#include "common/result-writer.h"
+#include "common/saturating-sender.h"
+#include "common/scenario-profile.h"
+#include "common/station-layout.h"
+#include "common/table-error-rate-model.h"
+#include "common/tcp-flow-tracer.h"
+#include "common/throughput-sampler.h"
+#include "common/wifi-data-mode.h"
+#include "common/wifi-device-configurator.h"
+
 #include "ns3/command-line.h"
+#include "ns3/boolean.h"
 #include "ns3/config.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/global-value.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
@@ -50,38 +71,54 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-model.h"
 #include "ns3/on-off-helper.h"
+#include "ns3/onoff-application.h"
 #include "ns3/packet-sink-helper.h"
 #include "ns3/packet-sink.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/ssid.h"
 #include "ns3/string.h"
+#include "ns3/tcp-l4-protocol.h"
 #include "ns3/tcp-westwood-plus.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/yans-wifi-helper.h"
 
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 NS_LOG_COMPONENT_DEFINE("wifi-tcp");
 
 using namespace ns3;
 
-Ptr<PacketSink> sink;     //!< Pointer to the packet sink application
-uint64_t lastTotalRx = 0; //!< The value of the last total received bytes
-
 /**
- * Calculate the throughput
+ * Print the throughput measured during a completed sampling interval, labelled with the flow
+ * when several STAs send
+ *
+ * @param sampler the throughput sampler
+ * @param bucket the index of the interval
  */
 void
-CalculateThroughput()
+PrintThroughput(const ThroughputSampler& sampler, uint64_t bucket)
 {
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    double cur = (sink->GetTotalRx() - lastTotalRx) * 8.0 /
-                 1e5; /* Convert Application RX Packets to MBits. */
-    std::cout << now.GetSeconds() << "s: \t" << cur << " Mbit/s" << std::endl;
-    lastTotalRx = sink->GetTotalRx();
-    Simulator::Schedule(MilliSeconds(100), &CalculateThroughput);
+    Time end = sampler.GetBucketStart(bucket + 1);
+    for (uint32_t flow = 0; flow < sampler.GetNFlows(); ++flow)
+    {
+        std::cout << end.GetSeconds() << "s: \t" << sampler.GetThroughput(flow, bucket)
+                  << " Mbit/s";
+        if (sampler.GetNFlows() > 1)
+        {
+            std::cout << " (" << sampler.GetLabel(flow) << ")";
+        }
+        std::cout << "\n";
+    }
 }
 
 int
 main(int argc, char* argv[])
 {
+    ScenarioProfile profile;
     uint32_t payloadSize = 1472;           /* Transport layer payload size in bytes. */
     std::string dataRate = "100Mbps";      /* Application layer datarate. */
     std::string tcpVariant = "TcpNewReno"; /* TCP variant type. */
@@ -93,6 +130,34 @@ main(int argc, char* argv[])
     bool enableLargeAmpdu = false;               /* Enable/disable A-MPDU */
     bool enableRts = false;               /* Enable/disable CTS/RTS */
     std::string frequencyBand = "5GHz";     /* Set to '5GHz or '2_4GHz' ;  Frequency band to use */
+    uint32_t replications = 1;             /* Number of forked runs sharing one setup */
+    std::string resultsFile;               /* File for the throughput time series, console if empty */
+    std::string resultsFormat = "csv";     /* Format of the results file: csv or binary */
+    uint32_t pcapSnapLength = 0;           /* Bytes captured per frame, 0 for whole frames */
+    uint32_t pcapSampling = 1;             /* Capture one frame out of this many per device */
+    std::string pcapStations = "all";      /* Captured devices: all, or a list of ap and STA indices */
+    bool pcapBackground = true;            /* Write the captures from a separate thread */
+    bool profiling = false;                /* Print the setup and run time and the event count */
+    bool profileEvents = false;            /* Time the events of every callback type */
+    std::string scheduler = "map";         /* Event scheduler: map, heap, list, calendar, ... */
+    std::string traffic = "onoff";         /* Sender: onoff (dataRate) or saturate (bulk TCP) */
+    bool leanPackets = false;              /* Saturating senders without TCP options */
+    bool cachePropagation = true;          /* Compute the loss and delay of each link once */
+    std::string errorModel = "yans";       /* Error rate model: yans or table (interpolated Yans) */
+    double convergence = 0;                /* Relative CI half width ending the run, 0 for none */
+    double warmup = 1;                     /* Sampled seconds discarded by the stopping rule */
+    double batchLength = 0.5;              /* Batch length in seconds of the stopping rule */
+    std::string distanceSweep;             /* STA distances start:end:step swept in one run */
+    bool continuousSweep = false;          /* Move the STA steadily instead of in steps */
+    double dwellTime = 2;                  /* Seconds spent at each distance of the sweep */
+    double sweepSettle = 0.5;              /* Seconds discarded after each step of the sweep */
+    bool delayProbe = false;               /* Measure the delay and jitter of every flow */
+    std::string tcpVariants;               /* Compared TCP variants, one STA flow each */
+    std::string tcpTrace;                  /* File for the cwnd, ssthresh and RTT time series */
+    std::string standard = "n";            /* Wi-Fi standard: n, ac or ax */
+    uint32_t channelWidth = 20;            /* Channel width in MHz */
+    uint32_t nss = 1;                      /* Number of spatial streams */
+    uint32_t guardInterval = 800;          /* Guard interval in ns */
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
@@ -103,33 +168,184 @@ main(int argc, char* argv[])
                  "TcpHybla, TcpHighSpeed, TcpHtcp, TcpVegas, TcpScalable, TcpVeno, "
                  "TcpBic, TcpYeah, TcpIllinois, TcpWestwood, TcpWestwoodPlus, TcpLedbat ",
                  tcpVariant);
-    cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
+    cmd.AddValue("phyRate",
+                 "Physical layer bitrate: HtMcs0-31, VhtMcs0-9 or HeMcs0-11 as per the standard",
+                 phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
     cmd.AddValue("pcap", "Enable/disable PCAP Tracing", pcapTracing);
+    cmd.AddValue("enableRts", "Enable/disable RTS/CTS", enableRts);
+    cmd.AddValue("enableLargeAmpdu",
+                 "Enable/disable large A-MPDU (BE_MaxAmpduSize is 4000 bytes if disabled)",
+                 enableLargeAmpdu);
+    cmd.AddValue("replications",
+                 "Number of runs simulated from a single setup, each in a forked child "
+                 "using RngRun, RngRun+1, ...",
+                 replications);
+    cmd.AddValue("results",
+                 "File receiving the throughput time series instead of the console",
+                 resultsFile);
+    cmd.AddValue("resultsFormat", "Format of the results file: csv or binary", resultsFormat);
+    cmd.AddValue("pcapSnapLength",
+                 "Bytes captured per frame, radiotap header included (0 for whole frames, "
+                 "128 keeps the MAC header)",
+                 pcapSnapLength);
+    cmd.AddValue("pcapSampling", "Capture one frame out of this many per device", pcapSampling);
+    cmd.AddValue("pcapStations",
+                 "Devices to capture: all, or a comma separated list of ap and STA indices",
+                 pcapStations);
+    cmd.AddValue("pcapBackground",
+                 "Write the captures from a background thread instead of the simulation thread",
+                 pcapBackground);
+    cmd.AddValue("profile", "Print the setup and run time and the number of events", profiling);
+    cmd.AddValue("profileEvents",
+                 "Time every event and report the most expensive callback types at the end, "
+                 "with a folded stack file (see ns3::ProfilingSimulatorImpl)",
+                 profileEvents);
+    cmd.AddValue("scheduler",
+                 "Event scheduler: map (the default), heap, list, calendar, priority, radix "
+                 "(RadixHeapScheduler) or the TypeId of a Scheduler",
+                 scheduler);
+    cmd.AddValue("traffic",
+                 "Sender of each station: onoff (OnOffApplication at dataRate) or saturate "
+                 "(SaturatingSender, keeping the TCP send buffer full without timers)",
+                 traffic);
+    cmd.AddValue("leanPackets",
+                 "With --traffic=saturate, open the connections without the TCP timestamp and "
+                 "SACK options, whose per-segment work the saturating senders then skip",
+                 leanPackets);
+    cmd.AddValue("cachePropagation",
+                 "Cache the propagation loss and delay of every pair of nodes until one moves",
+                 cachePropagation);
+    cmd.AddValue("errorModel",
+                 "Error rate model: yans, or table for Yans interpolated from precomputed tables "
+                 "(within 1e-3 of the chunk success rate)",
+                 errorModel);
+    cmd.AddValue("convergence",
+                 "Stop once the 95% confidence interval of the throughput of every flow, from "
+                 "batch means after the warm-up, is within this fraction of the mean (e.g. 0.05); "
+                 "simulationTime becomes the maximum. 0 runs for simulationTime",
+                 convergence);
+    cmd.AddValue("warmup",
+                 "Seconds of throughput discarded by the stopping rule and its average",
+                 warmup);
+    cmd.AddValue("batchLength", "Length in seconds of a batch of the stopping rule", batchLength);
+    cmd.AddValue("distanceSweep",
+                 "Move the STA through the distances start:end:step in meters (e.g. 5:165:10) "
+                 "and report the throughput at each one; simulationTime becomes the length of "
+                 "the sweep",
+                 distanceSweep);
+    cmd.AddValue("continuousSweep",
+                 "Move the STA at constant velocity through the sweep instead of in steps "
+                 "(disables cachePropagation)",
+                 continuousSweep);
+    cmd.AddValue("dwellTime", "Seconds spent at each distance of the sweep", dwellTime);
+    cmd.AddValue("sweepSettle",
+                 "Seconds discarded after each step of the sweep, while TCP adapts",
+                 sweepSettle);
+    cmd.AddValue("delayProbe",
+                 "Tag the packets of every flow and report their one-way delay and jitter "
+                 "percentiles, loss and reordering (see ns3::FlowDelayProbe)",
+                 delayProbe);
+    cmd.AddValue("tcpVariants",
+                 "Comma separated TCP variants compared side by side (e.g. "
+                 "TcpNewReno,TcpWestwoodPlus,TcpVegas,TcpCubic): one STA per variant, each "
+                 "sending its own flow with that congestion control over the shared link",
+                 tcpVariants);
+    cmd.AddValue("tcpTrace",
+                 "File receiving the congestion window, slow start threshold, RTT and "
+                 "retransmissions of every flow every 100 ms (format of resultsFormat)",
+                 tcpTrace);
+    cmd.AddValue("standard",
+                 "Wi-Fi standard: n (HtMcs modes), ac (VhtMcs modes) or ax (HeMcs modes)",
+                 standard);
+    cmd.AddValue("channelWidth",
+                 "Channel width in MHz: 20 or 40 for n, up to 80 and 160 for ac and ax",
+                 channelWidth);
+    cmd.AddValue("nss",
+                 "Number of spatial streams (and antennas); with n it must match the MCS, "
+                 "e.g. 2 for HtMcs8 to HtMcs15",
+                 nss);
+    cmd.AddValue("guardInterval",
+                 "Guard interval in ns: 800 or 400 for n and ac, 800, 1600 or 3200 for ax",
+                 guardInterval);
     cmd.Parse(argc, argv);
 
+    if (profileEvents)
+    {
+        // Before the first use of the simulator, which creates the implementation
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(ProfilingSimulatorImpl::GetTypeId().GetName()));
+    }
+    GlobalValue::Bind("SchedulerType", StringValue(GetSchedulerTypeName(scheduler)));
+    NS_ABORT_MSG_UNLESS(traffic == "onoff" || traffic == "saturate",
+                        "Unknown traffic '" << traffic << "'");
+    NS_ABORT_MSG_IF(leanPackets && traffic != "saturate", "leanPackets needs --traffic=saturate");
+
+    /* Optional throughput versus distance sweep, replacing the fixed STA position */
+    std::unique_ptr<DistanceSweep> sweep;
+    if (!distanceSweep.empty())
+    {
+        NS_ABORT_MSG_IF(convergence > 0, "The stopping rule cannot end a distance sweep");
+        DistanceSweep::Config sweepConfig;
+        DistanceSweep::ParseBands(distanceSweep, sweepConfig);
+        sweepConfig.continuous = continuousSweep;
+        sweepConfig.begin = Seconds(1.0);
+        sweepConfig.dwell = Seconds(dwellTime);
+        sweepConfig.settle = Seconds(sweepSettle);
+        sweep = std::make_unique<DistanceSweep>(sweepConfig);
+        simulationTime = (sweep->GetEnd() - sweepConfig.begin).GetSeconds();
+        if (continuousSweep && cachePropagation)
+        {
+            /* The cached loss would only be refreshed when the velocity changes */
+            std::cout << "The propagation cache is disabled by the continuous sweep" << std::endl;
+            cachePropagation = false;
+        }
+    }
+
     tcpVariant = std::string("ns3::") + tcpVariant;
     // Select TCP variant
     TypeId tcpTid;
     NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe(tcpVariant, &tcpTid),
                         "TypeId " << tcpVariant << " not found");
-    Config::SetDefault("ns3::TcpL4Protocol::SocketType",
-                       TypeIdValue(TypeId::LookupByName(tcpVariant)));
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(tcpTid));
+
+    /* Optional side-by-side comparison, with one STA per variant */
+    std::vector<std::string> variantNames;
+    std::vector<TypeId> variantTids;
+    std::istringstream variantList(tcpVariants);
+    for (std::string name; std::getline(variantList, name, ',');)
+    {
+        TypeId tid;
+        NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe("ns3::" + name, &tid),
+                            "TypeId ns3::" << name << " not found");
+        variantNames.push_back(name);
+        variantTids.push_back(tid);
+    }
+    NS_ABORT_MSG_IF(sweep && !variantNames.empty(), "A distance sweep moves a single STA");
+    uint32_t nStations = variantNames.empty() ? 1 : variantNames.size();
 
     /* Configure TCP Options */
     Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(payloadSize));
 
-    if (enableRts)
+    /* Standard and data mode of the link, and its theoretical PHY rate */
+    NS_ABORT_MSG_IF(nss == 0 || nss > 8, "1 to 8 spatial streams are supported, not " << nss);
+    WifiDataMode dataMode =
+        ParseWifiDataMode(standard, phyRate, channelWidth, nss, NanoSeconds(guardInterval));
+    NS_ABORT_MSG_IF(frequencyBand == "2_4GHz" && (standard == "ac" || channelWidth > 40),
+                    "The 2.4 GHz band has no 802.11ac and no channel wider than 40 MHz");
+    double phyRateMbps = dataMode.GetPhyRate() / 1e6;
+
+    WifiMacHelper wifiMac;
+    WifiHelper wifiHelper;
+    wifiHelper.SetStandard(dataMode.standard);
+    if (standard == "ax")
     {
-        Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(0));
+        wifiHelper.ConfigHeOptions("GuardInterval", TimeValue(dataMode.guardInterval));
     }
-    else
+    else if (guardInterval == 400)
     {
-        Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(999999));
+        wifiHelper.ConfigHtOptions("ShortGuardIntervalSupported", BooleanValue(true));
     }
-    WifiMacHelper wifiMac;
-    WifiHelper wifiHelper;
-    wifiHelper.SetStandard(WIFI_STANDARD_80211n);
 
     /* Set up Legacy Channel */
     YansWifiChannelHelper wifiChannel;
@@ -151,15 +367,42 @@ main(int argc, char* argv[])
 
     /* Setup Physical Layer */
     YansWifiPhyHelper wifiPhy;
-    wifiPhy.SetChannel(wifiChannel.Create());
-    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    Ptr<YansWifiChannel> channel = wifiChannel.Create();
+    if (cachePropagation)
+    {
+        /* The nodes do not move (the STA only jumps in a stepwise sweep), so the Friis loss and
+         * the delay of every link are computed once per position instead of once per frame and
+         * receiver */
+        EnablePropagationCache(channel);
+    }
+    wifiPhy.SetChannel(channel);
+    if (errorModel == "yans")
+    {
+        wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    }
+    else if (errorModel == "table")
+    {
+        wifiPhy.SetErrorRateModel(TableErrorRateModel::GetTypeId().GetName());
+    }
+    else
+    {
+        std::cout << "Invalid error model. Please set to 'yans' or 'table'" << std::endl;
+        return 1;
+    }
+    /* 20 MHz stays on channel 36 (or 1); wider channels take the first channel of their width,
+     * i.e. channel number 0 */
+    std::string width = std::to_string(channelWidth);
     if (frequencyBand == "5GHz")
     {
-        wifiPhy.Set("ChannelSettings", StringValue("{36, 0, BAND_5GHZ, 0}"));
+        wifiPhy.Set("ChannelSettings",
+                    StringValue("{" + std::string(channelWidth == 20 ? "36" : "0") + ", " + width +
+                                ", BAND_5GHZ, 0}"));
     }
     else if (frequencyBand == "2_4GHz")
     {
-        wifiPhy.Set("ChannelSettings", StringValue("{1, 0, BAND_2_4GHZ, 0}"));
+        wifiPhy.Set("ChannelSettings",
+                    StringValue("{" + std::string(channelWidth == 20 ? "1" : "0") + ", " + width +
+                                ", BAND_2_4GHZ, 0}"));
     }
     else
     {
@@ -167,6 +410,13 @@ main(int argc, char* argv[])
         return 1;
     }
     
+    if (nss > 1)
+    {
+        wifiPhy.Set("Antennas", UintegerValue(nss));
+        wifiPhy.Set("MaxSupportedTxSpatialStreams", UintegerValue(nss));
+        wifiPhy.Set("MaxSupportedRxSpatialStreams", UintegerValue(nss));
+    }
+
     wifiHelper.SetRemoteStationManager("ns3::ConstantRateWifiManager",
                                        "DataMode",
                                        StringValue(phyRate),
@@ -174,9 +424,14 @@ main(int argc, char* argv[])
                                        StringValue("HtMcs0"));
 
     NodeContainer networkNodes;
-    networkNodes.Create(2);
+    networkNodes.Create(1 + nStations);
     Ptr<Node> apWifiNode = networkNodes.Get(0);
-    Ptr<Node> staWifiNode = networkNodes.Get(1);
+    NodeContainer staWifiNodes;
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        staWifiNodes.Add(networkNodes.Get(1 + i));
+    }
+    Ptr<Node> staWifiNode = staWifiNodes.Get(0);
 
     /* Configure AP */
     Ssid ssid = Ssid("network");
@@ -189,12 +444,18 @@ main(int argc, char* argv[])
     wifiMac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
 
     NetDeviceContainer staDevices;
-    staDevices = wifiHelper.Install(wifiPhy, wifiMac, staWifiNode);
+    staDevices = wifiHelper.Install(wifiPhy, wifiMac, staWifiNodes);
 
+    /* Configure the installed devices through their objects, rather than with Config paths
+     * matched against every device of every node */
+    WifiDeviceConfigurator deviceConfigurator;
+    deviceConfigurator.SetRtsCtsThreshold(enableRts ? 0 : 999999);
     if (!enableLargeAmpdu)
     {
-        Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/BE_MaxAmpduSize", UintegerValue (4000)); 
+        deviceConfigurator.SetBeMaxAmpduSize(4000);
     }
+    deviceConfigurator.Apply(apDevice);
+    deviceConfigurator.Apply(staDevices);
     
 
     /* Mobility model */
@@ -209,11 +470,34 @@ main(int argc, char* argv[])
     mobility.SetPositionAllocator(positionAlloc);
     mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
     mobility.Install(apWifiNode);                   // Position is assigned here - order of positionAlloc is important
-    mobility.Install(staWifiNode);
+    if (sweep)
+    {
+        /* The sweep places the STA and schedules its moves */
+        mobility.SetMobilityModel("ns3::ConstantVelocityMobilityModel");
+    }
+    if (nStations > 1)
+    {
+        /* The compared STAs surround the AP at the distance of the single STA */
+        mobility.SetPositionAllocator(CreateStationLayout("ring", nStations, 10.0));
+    }
+    mobility.Install(staWifiNodes);
+    if (sweep)
+    {
+        sweep->Install(staWifiNode->GetObject<ConstantVelocityMobilityModel>(),
+                       apWifiNode->GetObject<MobilityModel>()->GetPosition());
+    }
 
     /* Internet stack */
     InternetStackHelper stack;
     stack.Install(networkNodes);
+    /* A compared flow is the only one of its STA, so the socket type of the STA's TCP is the
+     * congestion control of the flow's socket */
+    for (uint32_t i = 0; i < variantTids.size(); ++i)
+    {
+        staWifiNodes.Get(i)->GetObject<TcpL4Protocol>()->SetAttribute(
+            "SocketType",
+            TypeIdValue(variantTids[i]));
+    }
 
     Ipv4AddressHelper address;
     address.SetBase("10.0.0.0", "255.255.255.0");
@@ -229,7 +513,7 @@ main(int argc, char* argv[])
     PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
                                 InetSocketAddress(Ipv4Address::GetAny(), 9));
     ApplicationContainer sinkApp = sinkHelper.Install(apWifiNode);
-    sink = StaticCast<PacketSink>(sinkApp.Get(0));
+    Ptr<PacketSink> sink = StaticCast<PacketSink>(sinkApp.Get(0));
 
     /* Install TCP/UDP Transmitter on the station */
     OnOffHelper server("ns3::TcpSocketFactory", (InetSocketAddress(apInterface.GetAddress(0), 9)));
@@ -237,29 +521,340 @@ main(int argc, char* argv[])
     server.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     server.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
     server.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
-    ApplicationContainer serverApp = server.Install(staWifiNode);
+    ApplicationContainer serverApp;
+    if (traffic == "saturate")
+    {
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            auto sender = CreateObject<SaturatingSender>();
+            sender->SetAttribute("Remote",
+                                 AddressValue(InetSocketAddress(apInterface.GetAddress(0), 9)));
+            sender->SetAttribute("SendSize", UintegerValue(payloadSize));
+            sender->SetAttribute("Lean", BooleanValue(leanPackets));
+            staWifiNodes.Get(i)->AddApplication(sender);
+            serverApp.Add(sender);
+        }
+    }
+    else
+    {
+        serverApp = server.Install(staWifiNodes);
+    }
 
     /* Start Applications */
     sinkApp.Start(Seconds(0.0));
     serverApp.Start(Seconds(1.0));
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+
+    /* Optional delay measurement, from the sender's transmit trace to the sink */
+    std::unique_ptr<FlowDelayProbe> flowDelayProbe;
+    if (delayProbe)
+    {
+        flowDelayProbe = std::make_unique<FlowDelayProbe>();
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            flowDelayProbe->AddFlow(serverApp.Get(i), "STA" + std::to_string(i));
+        }
+        flowDelayProbe->Connect(sink);
+    }
+
+    /* Sample the throughput every 100 ms from the sink's receive trace */
+    ThroughputSampler sampler(Seconds(1.0), MilliSeconds(100));
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        sampler.AddFlow(staInterface.GetAddress(i), nStations > 1 ? variantNames[i] : "STA");
+    }
+    sampler.Connect(sink);
+
+    /* Optional congestion control time series. The senders create their sockets when they start,
+     * so the sockets are traced right after, before the handshake completes */
+    std::unique_ptr<TcpFlowTracer> tcpTracer;
+    if (nStations > 1 || !tcpTrace.empty())
+    {
+        tcpTracer = std::make_unique<TcpFlowTracer>(Seconds(1.0), MilliSeconds(100));
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            tcpTracer->AddFlow(sampler.GetLabel(i));
+        }
+        Simulator::Schedule(Seconds(1.0) + NanoSeconds(1), [&]() {
+            for (uint32_t i = 0; i < serverApp.GetN(); ++i)
+            {
+                Ptr<Application> app = serverApp.Get(i);
+                auto onOff = DynamicCast<OnOffApplication>(app);
+                tcpTracer->Connect(i,
+                                   onOff ? onOff->GetSocket()
+                                         : StaticCast<SaturatingSender>(app)->GetSocket());
+            }
+        });
+    }
+    /* Bytes of each flow at the end of the warm-up, for the goodput sustained after it */
+    std::vector<uint64_t> warmupBytes(nStations, 0);
+    if (nStations > 1)
+    {
+        Simulator::Schedule(Seconds(1.0 + warmup), [&]() {
+            for (uint32_t i = 0; i < nStations; ++i)
+            {
+                warmupBytes[i] = sampler.GetTotalBytes(i);
+            }
+        });
+    }
+    std::unique_ptr<ResultWriter> resultWriter;
+    if (!resultsFile.empty() && replications > 1)
+    {
+        std::cout << "The results file is not written when running replications" << std::endl;
+    }
+    else if (!resultsFile.empty())
+    {
+        resultWriter =
+            std::make_unique<ResultWriter>(resultsFile, ResultWriter::GetFormat(resultsFormat));
+        resultWriter->AddMetadata("scenario", "q2");
+        resultWriter->AddMetadata("payloadSize", payloadSize);
+        resultWriter->AddMetadata("dataRate", dataRate);
+        resultWriter->AddMetadata("tcpVariant", tcpVariant);
+        resultWriter->AddMetadata("phyRate", phyRate);
+        resultWriter->AddMetadata("standard", standard);
+        resultWriter->AddMetadata("channelWidth", channelWidth);
+        resultWriter->AddMetadata("nss", nss);
+        resultWriter->AddMetadata("guardInterval", guardInterval);
+        resultWriter->AddMetadata("phyRateMbps", phyRateMbps);
+        resultWriter->AddMetadata("simulationTime", simulationTime);
+        resultWriter->AddMetadata("enableRts", enableRts);
+        resultWriter->AddMetadata("enableLargeAmpdu", enableLargeAmpdu);
+        resultWriter->AddMetadata("frequencyBand", frequencyBand);
+        resultWriter->AddMetadata("errorModel", errorModel);
+        resultWriter->AddMetadata("scheduler", scheduler);
+        resultWriter->AddMetadata("traffic", traffic);
+        resultWriter->AddMetadata("leanPackets", leanPackets);
+        if (nStations > 1)
+        {
+            resultWriter->AddMetadata("tcpVariants", tcpVariants);
+        }
+        if (sweep)
+        {
+            resultWriter->AddMetadata("distanceSweep", distanceSweep);
+            resultWriter->AddMetadata("continuousSweep", continuousSweep);
+            resultWriter->AddMetadata("dwellTime", dwellTime);
+        }
+        resultWriter->AddMetadata("run", RngSeedManager::GetRun());
+        AddThroughputColumns(*resultWriter, sampler);
+        sampler.SetBucketCallback([&resultWriter](const ThroughputSampler& s, uint64_t bucket) {
+            WriteThroughputRows(*resultWriter, s, bucket);
+        });
+    }
+    else if (replications <= 1)
+    {
+        sampler.SetBucketCallback(&PrintThroughput);
+    }
+
+    /* Optional stopping rule, chained after the bucket callback set above */
+    std::unique_ptr<ConvergenceMonitor> convergenceMonitor;
+    if (convergence > 0)
+    {
+        ConvergenceMonitor::Config convergenceConfig;
+        convergenceConfig.warmup = Seconds(warmup);
+        convergenceConfig.batch = Seconds(batchLength);
+        convergenceConfig.relativeHalfWidth = convergence;
+        convergenceMonitor = std::make_unique<ConvergenceMonitor>(convergenceConfig);
+        convergenceMonitor->Attach(sampler);
+        if (resultWriter)
+        {
+            resultWriter->AddMetadata("convergence", convergence);
+            resultWriter->AddMetadata("warmup", warmup);
+        }
+    }
+
+    if (sweep)
+    {
+        sweep->Attach(sampler);
+    }
+
+    /* Throughput in Mbit/s of all flows: the sum of their means of the batch means after the
+     * warm-up with the stopping rule, the average over simulationTime otherwise */
+    auto averageThroughput = [&]() {
+        if (!convergenceMonitor)
+        {
+            return (sink->GetTotalRx() * 8) / (1e6 * simulationTime);
+        }
+        double total = 0;
+        for (uint32_t i = 0; i < sampler.GetNFlows(); ++i)
+        {
+            total += convergenceMonitor->GetSummary(i).mean;
+        }
+        return total;
+    };
+    /* Goodput of a compared flow in Mbit/s after the warm-up, up to the end of the run */
+    auto sustainedThroughput = [&](uint32_t i) {
+        double seconds = (Simulator::Now() - Seconds(1.0 + warmup)).GetSeconds();
+        return seconds > 0 ? ((sampler.GetTotalBytes(i) - warmupBytes[i]) * 8) / (1e6 * seconds)
+                           : 0;
+    };
 
     /* Enable Traces */
-    if (pcapTracing)
+    std::unique_ptr<WifiCaptureWriter> captureWriter;
+    if (pcapTracing && replications > 1)
     {
-        wifiPhy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
-        wifiPhy.EnablePcap("module2-AccessPoint", apDevice);
-        wifiPhy.EnablePcap("module2-Station", staDevices);
+        std::cout << "PCAP tracing is disabled when running replications" << std::endl;
+    }
+    else if (pcapTracing)
+    {
+        WifiCaptureWriter::Config captureConfig;
+        captureConfig.snapLength = pcapSnapLength;
+        captureConfig.sampling = pcapSampling;
+        captureConfig.background = pcapBackground;
+        captureWriter = std::make_unique<WifiCaptureWriter>(captureConfig);
+        CaptureStationFilter captureStations(pcapStations);
+        if (captureStations.IncludesAp())
+        {
+            captureWriter->Capture("module2-AccessPoint", apDevice);
+        }
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            if (captureStations.IncludesStation(i))
+            {
+                captureWriter->Capture("module2-Station", staDevices.Get(i));
+            }
+        }
     }
 
     /* Start Simulation */
     Simulator::Stop(Seconds(simulationTime + 1));
+
+    if (replications > 1)
+    {
+        /* Every replication re-seeds the streams created during the setup and simulates in a
+         * forked copy of this process */
+        auto results = RunForkedReplications(
+            replications,
+            RngSeedManager::GetRun(),
+            0,
+            [&]() {
+                int64_t stream = 1;
+                stream += wifiChannel.AssignStreams(channel, stream);
+                stream += wifiHelper.AssignStreams(apDevice, stream);
+                stream += wifiHelper.AssignStreams(staDevices, stream);
+                stream += stack.AssignStreams(networkNodes, stream);
+                server.AssignStreams(networkNodes, stream);
+            },
+            [&]() {
+                std::vector<double> values{averageThroughput()};
+                for (uint32_t band = 0; sweep && band < sweep->GetNBands(); ++band)
+                {
+                    values.push_back(sweep->GetThroughput(band));
+                }
+                for (uint32_t i = 0; nStations > 1 && i < nStations; ++i)
+                {
+                    values.push_back(sustainedThroughput(i));
+                }
+                return values;
+            });
+        Simulator::Destroy();
+
+        for (const auto& result : results)
+        {
+            std::cout << "Run " << result.run << ": ";
+            if (result.ok)
+            {
+                std::cout << result.values[0] << " Mbit/s" << std::endl;
+            }
+            else
+            {
+                std::cout << "failed" << std::endl;
+            }
+        }
+        auto summary = SummarizeReplications(results);
+        NS_ABORT_MSG_IF(summary.empty(), "All replications failed");
+        std::cout << "\nAverage throughput: " << summary[0].mean << " Mbit/s (+/- "
+                  << summary[0].halfWidth << " at 95% confidence, " << summary[0].count
+                  << " runs)" << std::endl;
+        std::cout << "MAC efficiency: " << 100 * summary[0].mean / phyRateMbps << "% of the "
+                  << phyRateMbps << " Mbit/s PHY rate" << std::endl;
+        for (uint32_t band = 0; sweep && band < sweep->GetNBands(); ++band)
+        {
+            std::cout << sweep->GetDistance(band) << " m: \t" << summary[band + 1].mean
+                      << " Mbit/s (+/- " << summary[band + 1].halfWidth << ")" << std::endl;
+        }
+        for (uint32_t i = 0; nStations > 1 && i < nStations; ++i)
+        {
+            std::cout << variantNames[i] << ": \t" << summary[i + 1].mean
+                      << " Mbit/s sustained (+/- " << summary[i + 1].halfWidth << ")"
+                      << std::endl;
+        }
+        return 0;
+    }
+
+    profile.EndSetup();
     Simulator::Run();
+    profile.EndRun();
+    sampler.Flush(Simulator::Now());
+    if (resultWriter)
+    {
+        resultWriter->Close();
+    }
+    if (captureWriter)
+    {
+        captureWriter->Close();
+        std::cout << "Captured " << captureWriter->GetNRecords() << " frames ("
+                  << captureWriter->GetNSkipped() << " skipped by sampling)" << std::endl;
+    }
+    if (profiling)
+    {
+        profile.Report(std::cout);
+    }
+
+    if (convergenceMonitor)
+    {
+        convergenceMonitor->Print(std::cout);
+    }
+    if (sweep)
+    {
+        sweep->Print(std::cout);
+    }
+    if (flowDelayProbe)
+    {
+        flowDelayProbe->Flush();
+        flowDelayProbe->Print(std::cout);
+    }
+    if (tcpTracer)
+    {
+        tcpTracer->Flush(Simulator::Now());
+        if (!tcpTrace.empty())
+        {
+            ResultWriter tcpWriter(tcpTrace, ResultWriter::GetFormat(resultsFormat));
+            tcpWriter.AddMetadata("scenario", "q2");
+            tcpWriter.AddMetadata("run", RngSeedManager::GetRun());
+            tcpTracer->Write(tcpWriter);
+        }
+        if (nStations > 1)
+        {
+            tcpTracer->Print(std::cout);
+        }
+    }
+    if (nStations > 1)
+    {
+        /* The variants from the highest goodput sustained after the warm-up */
+        std::vector<uint32_t> ranking;
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            ranking.push_back(i);
+        }
+        std::stable_sort(ranking.begin(), ranking.end(), [&](uint32_t a, uint32_t b) {
+            return sustainedThroughput(a) > sustainedThroughput(b);
+        });
+        std::cout << "\nVariant\taverage (Mbit/s)\tsustained after " << warmup << " s (Mbit/s)\n";
+        for (uint32_t i : ranking)
+        {
+            std::cout << variantNames[i] << "\t"
+                      << (sampler.GetTotalBytes(i) * 8) / (1e6 * simulationTime) << "\t"
+                      << sustainedThroughput(i) << "\n";
+        }
+    }
 
-    double averageThroughput = ((sink->GetTotalRx() * 8) / (1e6 * simulationTime));
+    double throughput = averageThroughput();
 
     Simulator::Destroy();
 
-    std::cout << "\nAverage throughput: " << averageThroughput << " Mbit/s" << std::endl;
+    std::cout << "\nAverage throughput: " << throughput << " Mbit/s" << std::endl;
+    std::cout << "PHY rate: " << phyRateMbps << " Mbit/s (" << phyRate << ", " << channelWidth
+              << " MHz, " << nss << " spatial streams, " << guardInterval
+              << " ns guard interval), MAC efficiency " << 100 * throughput / phyRateMbps << "%"
+              << std::endl;
     return 0;
 }
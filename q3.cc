@@ -25,6 +25,10 @@
  *   |      |      |
  *   n3     n1     n2
  *
+ * The default layout has two stations on both sides of the AP; --nStations
+ * and --topology place any number of stations on a ring, a line, a grid or a
+ * random disk around the AP.
+ *
  * In this example, an HT station sends TCP packets to the access point.
  * We report the total throughput received during a window of 100ms.
  * The user can specify the application data rate and choose the variant
@@ -41,53 +45,73 @@
  * Date: September 14, 2025
  */
 
+#include "common/capture-writer.h"
+#include "common/convergence-monitor.h"
+#include "common/flow-delay-probe.h"
+#include "common/hidden-node-rts-wifi-manager.h"
+#include "common/profiling-simulator-impl.h"
+#include "common/propagation-cache.h"
+#include "common/pruned-wifi-channel.h"
+#include "common/radix-heap-scheduler.h"
+#include "common/replication.h"
+#include "common/result-writer.h"
+#include "common/saturating-sender.h"
+#include "common/scenario-profile.h"
+#include "common/table-error-rate-model.h"
+#include "common/station-layout.h"
+#include "common/throughput-sampler.h"
+#include "common/udp-stream-sender.h"
+#include "common/wifi-device-configurator.h"
+
+#include "ns3/boolean.h"
 #include "ns3/command-line.h"
 #include "ns3/config.h"
+#include "ns3/global-value.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
-#include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/log.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-model.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/packet-sink-helper.h"
 #include "ns3/packet-sink.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/ssid.h"
 #include "ns3/string.h"
 #include "ns3/tcp-westwood-plus.h"
+#include "ns3/wifi-net-device.h"
 #include "ns3/yans-wifi-channel.h"
 #include "ns3/yans-wifi-helper.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 NS_LOG_COMPONENT_DEFINE("wifi-tcp");
 
 using namespace ns3;
 
-Ptr<PacketSink> sink_0;     //!< Pointer to the packet sink application
-Ptr<PacketSink> sink_1;     //!< Pointer to the packet sink application
-uint64_t lastTotalRx_0 = 0; //!< The value of the last total received bytes
-uint64_t lastTotalRx_1 = 0; //!< The value of the last total received bytes
-
 /**
- * Calculate the throughput
+ * Print the throughput of each station measured during a completed sampling interval
+ *
+ * @param sampler the throughput sampler
+ * @param bucket the index of the interval
  */
 void
-CalculateThroughput()
+PrintThroughput(const ThroughputSampler& sampler, uint64_t bucket)
 {
-    Time now = Simulator::Now(); /* Return the simulator's virtual time. */
-    double cur_0 = (sink_0->GetTotalRx() - lastTotalRx_0) * 8.0 /
-                 1e5; /* Convert Application RX Packets to MBits. */
-    double cur_1 = (sink_1->GetTotalRx() - lastTotalRx_1) * 8.0 /
-                 1e5; /* Convert Application RX Packets to MBits. */
-    std::cout << now.GetSeconds() << "s: \t" << cur_0 << " Mbit/s (STA0)" << std::endl;
-    std::cout << now.GetSeconds() << "s: \t" << cur_1 << " Mbit/s (STA1)" << std::endl;
-    lastTotalRx_0 = sink_0->GetTotalRx();
-    lastTotalRx_1 = sink_1->GetTotalRx();
-    Simulator::Schedule(MilliSeconds(100), &CalculateThroughput);
+    Time end = sampler.GetBucketStart(bucket + 1);
+    for (uint32_t flow = 0; flow < sampler.GetNFlows(); ++flow)
+    {
+        std::cout << end.GetSeconds() << "s: \t" << sampler.GetThroughput(flow, bucket)
+                  << " Mbit/s (" << sampler.GetLabel(flow) << ")\n";
+    }
 }
 
 int
 main(int argc, char* argv[])
 {
+    ScenarioProfile profile;
     uint32_t payloadSize = 1472;           /* Transport layer payload size in bytes. */
     std::string dataRate = "100Mbps";      /* Application layer datarate. */
     std::string tcpVariant = "TcpNewReno"; /* TCP variant type. */
@@ -96,7 +120,38 @@ main(int argc, char* argv[])
     bool pcapTracing = false;              /* PCAP Tracing is enabled or not. */
     bool enableLargeAmpdu = false;               /* Enable/disable A-MPDU */
     bool enableRts = false;               /* Enable/disable CTS/RTS */
+    bool adaptiveRts = false;              /* RTS/CTS per station, against hidden nodes */
+    bool delayProbe = false;               /* Measure the delay and jitter of every flow */
     std::string frequencyBand = "5GHz";     /* Set to '5GHz or '2_4GHz' ;  Frequency band to use */
+    uint32_t replications = 1;             /* Number of forked runs sharing one setup */
+    std::string resultsFile;               /* File for the throughput time series, console if empty */
+    std::string resultsFormat = "csv";     /* Format of the results file: csv or binary */
+    uint32_t pcapSnapLength = 0;           /* Bytes captured per frame, 0 for whole frames */
+    uint32_t pcapSampling = 1;             /* Capture one frame out of this many per device */
+    std::string pcapStations = "all";      /* Captured devices: all, or a list of ap and STA indices */
+    bool pcapBackground = true;            /* Write the captures from a separate thread */
+    bool profiling = false;                /* Print the setup and run time and the event count */
+    bool profileEvents = false;            /* Time the events of every callback type */
+    std::string scheduler = "map";         /* Event scheduler: map, heap, list, calendar, ... */
+    std::string traffic = "onoff";         /* Sender: onoff (dataRate) or saturate (bulk TCP) */
+    bool leanPackets = false;              /* Saturating senders without TCP options */
+    bool cachePropagation = true;          /* Compute the loss and delay of each link once */
+    std::string errorModel = "yans";       /* Error rate model: yans or table (interpolated Yans) */
+    double convergence = 0;                /* Relative CI half width ending the run, 0 for none */
+    double warmup = 1;                     /* Sampled seconds discarded by the stopping rule */
+    double batchLength = 0.5;              /* Batch length in seconds of the stopping rule */
+    bool pruneChannel = false;             /* Only deliver frames to the receivers in range */
+    double rxPowerFloor = -110;            /* Weakest power delivered by the pruned channel (dBm) */
+    double distance = 160;                 /* Distance in meters between the AP and each STA */
+    uint32_t nStations = 2;                /* Number of stations */
+    std::string topology = "ring";         /* Station layout: ring, line, grid or disk */
+    bool qosTraffic = false;               /* Add voice (VO) and video (VI) UDP flows per STA */
+    uint32_t voicePacketSize = 160;        /* UDP payload of a voice packet in bytes */
+    double voiceInterval = 0.02;           /* Seconds between two voice packets */
+    uint32_t videoPacketSize = 1316;       /* UDP payload of a video packet in bytes */
+    std::string videoRate = "4Mbps";       /* Rate of each video flow */
+    int voMaxAmpduSize = -1;               /* VO_MaxAmpduSize in bytes, -1 for the default */
+    int viMaxAmpduSize = -1;               /* VI_MaxAmpduSize in bytes, -1 for the default */
 
     /* Command line argument parser setup. */
     CommandLine cmd(__FILE__);
@@ -110,27 +165,127 @@ main(int argc, char* argv[])
     cmd.AddValue("phyRate", "Physical layer bitrate", phyRate);
     cmd.AddValue("simulationTime", "Simulation time in seconds", simulationTime);
     cmd.AddValue("pcap", "Enable/disable PCAP Tracing", pcapTracing);
+    cmd.AddValue("replications",
+                 "Number of runs simulated from a single setup, each in a forked child "
+                 "using RngRun, RngRun+1, ...",
+                 replications);
+    cmd.AddValue("results",
+                 "File receiving the throughput time series instead of the console",
+                 resultsFile);
+    cmd.AddValue("resultsFormat", "Format of the results file: csv or binary", resultsFormat);
+    cmd.AddValue("pcapSnapLength",
+                 "Bytes captured per frame, radiotap header included (0 for whole frames, "
+                 "128 keeps the MAC header)",
+                 pcapSnapLength);
+    cmd.AddValue("pcapSampling", "Capture one frame out of this many per device", pcapSampling);
+    cmd.AddValue("pcapStations",
+                 "Devices to capture: all, or a comma separated list of ap and STA indices",
+                 pcapStations);
+    cmd.AddValue("pcapBackground",
+                 "Write the captures from a background thread instead of the simulation thread",
+                 pcapBackground);
+    cmd.AddValue("profile", "Print the setup and run time and the number of events", profiling);
+    cmd.AddValue("profileEvents",
+                 "Time every event and report the most expensive callback types at the end, "
+                 "with a folded stack file (see ns3::ProfilingSimulatorImpl)",
+                 profileEvents);
+    cmd.AddValue("scheduler",
+                 "Event scheduler: map (the default), heap, list, calendar, priority, radix "
+                 "(RadixHeapScheduler) or the TypeId of a Scheduler",
+                 scheduler);
+    cmd.AddValue("traffic",
+                 "Sender of each station: onoff (OnOffApplication at dataRate) or saturate "
+                 "(SaturatingSender, keeping the TCP send buffer full without timers)",
+                 traffic);
+    cmd.AddValue("leanPackets",
+                 "With --traffic=saturate, open the connections without the TCP timestamp and "
+                 "SACK options, whose per-segment work the saturating senders then skip",
+                 leanPackets);
+    cmd.AddValue("cachePropagation",
+                 "Cache the propagation loss and delay of every pair of nodes until one moves",
+                 cachePropagation);
+    cmd.AddValue("errorModel",
+                 "Error rate model: yans, or table for Yans interpolated from precomputed tables "
+                 "(within 1e-3 of the chunk success rate)",
+                 errorModel);
+    cmd.AddValue("convergence",
+                 "Stop once the 95% confidence interval of the throughput of every flow, from "
+                 "batch means after the warm-up, is within this fraction of the mean (e.g. 0.05); "
+                 "simulationTime becomes the maximum. 0 runs for simulationTime",
+                 convergence);
+    cmd.AddValue("warmup",
+                 "Seconds of throughput discarded by the stopping rule and its average",
+                 warmup);
+    cmd.AddValue("batchLength", "Length in seconds of a batch of the stopping rule", batchLength);
+    cmd.AddValue("pruneChannel",
+                 "Only deliver frames to the receivers within the distance at which the Friis "
+                 "loss reaches rxPowerFloor, through one view of the channel per PHY",
+                 pruneChannel);
+    cmd.AddValue("rxPowerFloor",
+                 "Weakest received power in dBm delivered by the pruned channel (keep it below "
+                 "the -101 dBm receive sensitivity for results identical to the full channel)",
+                 rxPowerFloor);
+    cmd.AddValue("enableRts", "Enable/disable RTS/CTS", enableRts);
+    cmd.AddValue("adaptiveRts",
+                 "Enable RTS/CTS only for the stations whose transmissions keep being lost "
+                 "despite a high SNR, for a while (see ns3::HiddenNodeRtsWifiManager)",
+                 adaptiveRts);
+    cmd.AddValue("delayProbe",
+                 "Tag the packets of every flow and report their one-way delay and jitter "
+                 "percentiles, loss and reordering (see ns3::FlowDelayProbe)",
+                 delayProbe);
+    cmd.AddValue("enableLargeAmpdu",
+                 "Enable/disable large A-MPDU (BE_MaxAmpduSize is 4000 bytes if disabled)",
+                 enableLargeAmpdu);
+    cmd.AddValue("frequencyBand", "Frequency band to use: 5GHz or 2_4GHz", frequencyBand);
+    cmd.AddValue("distance",
+                 "Distance in meters between the AP and each STA (radius or half width of the "
+                 "layout)",
+                 distance);
+    cmd.AddValue("nStations", "Number of stations", nStations);
+    cmd.AddValue("topology",
+                 "Station layout around the AP: ring, line, grid or disk (uniformly random)",
+                 topology);
+    cmd.AddValue("qosTraffic",
+                 "Add a voice flow on AC_VO (ToS 0xc0) and a video flow on AC_VI (ToS 0xa0) from "
+                 "every STA, next to its TCP flow on AC_BE, and report the throughput and delay "
+                 "of each access category",
+                 qosTraffic);
+    cmd.AddValue("voicePacketSize", "UDP payload of a voice packet in bytes", voicePacketSize);
+    cmd.AddValue("voiceInterval", "Seconds between two voice packets", voiceInterval);
+    cmd.AddValue("videoPacketSize", "UDP payload of a video packet in bytes", videoPacketSize);
+    cmd.AddValue("videoRate", "Rate of the video flow of each STA", videoRate);
+    cmd.AddValue("voMaxAmpduSize",
+                 "Maximum A-MPDU size of AC_VO in bytes (-1 keeps the default, 0 disables "
+                 "aggregation)",
+                 voMaxAmpduSize);
+    cmd.AddValue("viMaxAmpduSize",
+                 "Maximum A-MPDU size of AC_VI in bytes (-1 keeps the default)",
+                 viMaxAmpduSize);
     cmd.Parse(argc, argv);
 
+    if (profileEvents)
+    {
+        // Before the first use of the simulator, which creates the implementation
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue(ProfilingSimulatorImpl::GetTypeId().GetName()));
+    }
+    GlobalValue::Bind("SchedulerType", StringValue(GetSchedulerTypeName(scheduler)));
+    NS_ABORT_MSG_UNLESS(traffic == "onoff" || traffic == "saturate",
+                        "Unknown traffic '" << traffic << "'");
+    NS_ABORT_MSG_IF(leanPackets && traffic != "saturate", "leanPackets needs --traffic=saturate");
+    NS_ABORT_MSG_IF(enableRts && adaptiveRts, "enableRts protects every frame already");
+
     tcpVariant = std::string("ns3::") + tcpVariant;
     // Select TCP variant
     TypeId tcpTid;
     NS_ABORT_MSG_UNLESS(TypeId::LookupByNameFailSafe(tcpVariant, &tcpTid),
                         "TypeId " << tcpVariant << " not found");
-    Config::SetDefault("ns3::TcpL4Protocol::SocketType",
-                       TypeIdValue(TypeId::LookupByName(tcpVariant)));
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(tcpTid));
 
     /* Configure TCP Options */
     Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(payloadSize));
 
-    if (enableRts)
-    {
-        Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(0));
-    }
-    else
-    {
-        Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", UintegerValue(999999));
-    }
     WifiMacHelper wifiMac;
     WifiHelper wifiHelper;
     wifiHelper.SetStandard(WIFI_STANDARD_80211n);
@@ -155,8 +310,27 @@ main(int argc, char* argv[])
 
     /* Setup Physical Layer */
     YansWifiPhyHelper wifiPhy;
-    wifiPhy.SetChannel(wifiChannel.Create());
-    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    Ptr<YansWifiChannel> channel = wifiChannel.Create();
+    if (cachePropagation)
+    {
+        /* The nodes do not move, so the Friis loss and the delay of every link are computed once
+         * instead of once per frame and receiver */
+        EnablePropagationCache(channel);
+    }
+    wifiPhy.SetChannel(channel);
+    if (errorModel == "yans")
+    {
+        wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    }
+    else if (errorModel == "table")
+    {
+        wifiPhy.SetErrorRateModel(TableErrorRateModel::GetTypeId().GetName());
+    }
+    else
+    {
+        std::cout << "Invalid error model. Please set to 'yans' or 'table'" << std::endl;
+        return 1;
+    }
     if (frequencyBand == "5GHz")
     {
         wifiPhy.Set("ChannelSettings", StringValue("{36, 0, BAND_5GHZ, 0}"));
@@ -171,17 +345,21 @@ main(int argc, char* argv[])
         return 1;
     }
     
-    wifiHelper.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+    wifiHelper.SetRemoteStationManager(adaptiveRts ? HiddenNodeRtsWifiManager::GetTypeId().GetName()
+                                                   : "ns3::ConstantRateWifiManager",
                                        "DataMode",
                                        StringValue(phyRate),
                                        "ControlMode",
                                        StringValue("HtMcs0"));
 
     NodeContainer networkNodes;
-    networkNodes.Create(3);
+    networkNodes.Create(1 + nStations);
     Ptr<Node> apWifiNode = networkNodes.Get(0);
-    Ptr<Node> staWifiNode_0 = networkNodes.Get(1);
-    Ptr<Node> staWifiNode_1 = networkNodes.Get(2);
+    NodeContainer staWifiNodes;
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        staWifiNodes.Add(networkNodes.Get(1 + i));
+    }
 
     /* Configure AP */
     Ssid ssid = Ssid("network");
@@ -192,53 +370,69 @@ main(int argc, char* argv[])
 
     /* Configure STA */
     wifiMac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
-    wifiMac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid)); //Second STA
 
-    NetDeviceContainer sta_0, sta_1;
-    sta_0 = wifiHelper.Install(wifiPhy, wifiMac, staWifiNode_0);
-    sta_1 = wifiHelper.Install(wifiPhy, wifiMac, staWifiNode_1);
+    NetDeviceContainer staDevices;
+    staDevices = wifiHelper.Install(wifiPhy, wifiMac, staWifiNodes);
 
+    /* Configure the installed devices through their objects, rather than with Config paths
+     * matched against every device of every node */
+    WifiDeviceConfigurator deviceConfigurator;
+    deviceConfigurator.SetRtsCtsThreshold(enableRts ? 0 : 999999);
     if (!enableLargeAmpdu)
     {
-        Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/BE_MaxAmpduSize", UintegerValue (4000)); 
+        deviceConfigurator.SetBeMaxAmpduSize(4000);
     }
+    if (voMaxAmpduSize >= 0)
+    {
+        deviceConfigurator.SetMacAttribute("VO_MaxAmpduSize", UintegerValue(voMaxAmpduSize));
+    }
+    if (viMaxAmpduSize >= 0)
+    {
+        deviceConfigurator.SetMacAttribute("VI_MaxAmpduSize", UintegerValue(viMaxAmpduSize));
+    }
+    deviceConfigurator.Apply(apDevice);
+    deviceConfigurator.Apply(staDevices);
     
 
     /* Mobility model */
     MobilityHelper mobility;
-    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
-    positionAlloc->Add(Vector(0.0, 0.0, 0.0));       // AP position
-    positionAlloc->Add(Vector(-160.0, 0.0, 0.0));     // STA_0 position - pay attention to distance calculation. Change just one coordinate for simple calculation
-    positionAlloc->Add(Vector(160.0, 0.0, 0.0));     // STA_1 position - pay attention to distance calculation. Change just one coordinate for simple calculation
-
-
-    mobility.SetPositionAllocator(positionAlloc);
+    Ptr<ListPositionAllocator> apPosition = CreateObject<ListPositionAllocator>();
+    apPosition->Add(Vector(0.0, 0.0, 0.0));       // AP position
     mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-    mobility.Install(apWifiNode);                   // Position is assigned here - order of positionAlloc is important
-    mobility.Install(staWifiNode_0);
-    mobility.Install(staWifiNode_1);
+    mobility.SetPositionAllocator(apPosition);
+    mobility.Install(apWifiNode);
+    // With the default ring of two stations, STA0 is at (-distance, 0) and STA1 at (distance, 0)
+    mobility.SetPositionAllocator(CreateStationLayout(topology, nStations, distance));
+    mobility.Install(staWifiNodes);                 // Positions are assigned in station order
+    Ptr<YansWifiChannelPruner> channelPruner;
+    if (pruneChannel)
+    {
+        /* Each PHY now sends on its own view of the channel, holding the PHYs in range */
+        channelPruner = PruneChannel(channel, rxPowerFloor);
+    }
 
     /* Internet stack */
     InternetStackHelper stack;
     stack.Install(networkNodes);
 
     Ipv4AddressHelper address;
-    address.SetBase("10.0.0.0", "255.255.255.0");
+    address.SetBase("10.0.0.0", "255.255.0.0");
     Ipv4InterfaceContainer apInterface;
     apInterface = address.Assign(apDevice);
-    Ipv4InterfaceContainer staInterface_0, staInterface_1;
-    staInterface_0 = address.Assign(sta_0);
-    staInterface_1 = address.Assign(sta_1);
+    Ipv4InterfaceContainer staInterfaces;
+    staInterfaces = address.Assign(staDevices);
 
-    /* Populate routing table */
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    /* Every node is on the same subnet, so no routing table is needed; global routing would make
+     * the setup quadratic in the number of stations */
 
-    /* Install TCP Receiver on the access point */
-    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
-                                InetSocketAddress(Ipv4Address::GetAny(), 9));
-    ApplicationContainer sinkApp = sinkHelper.Install(apWifiNode);
-    sink_0 = StaticCast<PacketSink>(sinkApp.Get(0));
-    sink_1 = StaticCast<PacketSink>(sinkApp.Get(0));
+    /* Install one TCP receiver per station on the access point, on ports 9, 10, ... */
+    ApplicationContainer sinkApps;
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(Ipv4Address::GetAny(), 9 + i));
+        sinkApps.Add(sinkHelper.Install(apWifiNode));
+    }
 
     /* Install TCP/UDP Transmitter on the station */
     OnOffHelper server("ns3::TcpSocketFactory", (InetSocketAddress(apInterface.GetAddress(0), 9)));
@@ -246,40 +440,356 @@ main(int argc, char* argv[])
     server.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
     server.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
     server.SetAttribute("DataRate", DataRateValue(DataRate(dataRate)));
-    ApplicationContainer serverApp_0 = server.Install(staWifiNode_0);
-    ApplicationContainer serverApp_1 = server.Install(staWifiNode_1);
+    ApplicationContainer serverApps;
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        AddressValue remote(InetSocketAddress(apInterface.GetAddress(0), 9 + i));
+        if (traffic == "saturate")
+        {
+            auto sender = CreateObject<SaturatingSender>();
+            sender->SetAttribute("Remote", remote);
+            sender->SetAttribute("SendSize", UintegerValue(payloadSize));
+            sender->SetAttribute("Lean", BooleanValue(leanPackets));
+            staWifiNodes.Get(i)->AddApplication(sender);
+            serverApps.Add(sender);
+        }
+        else
+        {
+            server.SetAttribute("Remote", remote);
+            serverApps.Add(server.Install(staWifiNodes.Get(i)));
+        }
+    }
+
+    /* Optional voice and video flows of every station, marked into AC_VO and AC_VI, to one UDP
+     * receiver per access category on the access point (ports 5000 and 5001) */
+    const std::vector<std::pair<std::string, uint8_t>> qosCategories = {{"VO", 0xc0},
+                                                                        {"VI", 0xa0}};
+    ApplicationContainer qosSinkApps;
+    ApplicationContainer qosApps; // Per station, one sender per category
+    if (qosTraffic)
+    {
+        for (std::size_t c = 0; c < qosCategories.size(); ++c)
+        {
+            PacketSinkHelper sinkHelper("ns3::UdpSocketFactory",
+                                        InetSocketAddress(Ipv4Address::GetAny(), 5000 + c));
+            qosSinkApps.Add(sinkHelper.Install(apWifiNode));
+        }
+        Time videoInterval = DataRate(videoRate).CalculateBytesTxTime(videoPacketSize);
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            for (std::size_t c = 0; c < qosCategories.size(); ++c)
+            {
+                bool voice = qosCategories[c].first == "VO";
+                auto sender = CreateObject<UdpStreamSender>();
+                sender->SetAttribute(
+                    "Remote",
+                    AddressValue(InetSocketAddress(apInterface.GetAddress(0), 5000 + c)));
+                sender->SetAttribute("Tos", UintegerValue(qosCategories[c].second));
+                sender->SetAttribute("PacketSize",
+                                     UintegerValue(voice ? voicePacketSize : videoPacketSize));
+                sender->SetAttribute("Interval",
+                                     TimeValue(voice ? Seconds(voiceInterval) : videoInterval));
+                staWifiNodes.Get(i)->AddApplication(sender);
+                qosApps.Add(sender);
+            }
+        }
+    }
+
+    /* Optional delay measurement, from each sender's transmit trace to its sink; the flows of the
+     * access categories follow those of the TCP senders */
+    std::unique_ptr<FlowDelayProbe> flowDelayProbe;
+    if (delayProbe || qosTraffic)
+    {
+        flowDelayProbe = std::make_unique<FlowDelayProbe>();
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            flowDelayProbe->AddFlow(serverApps.Get(i), "STA" + std::to_string(i));
+            flowDelayProbe->Connect(StaticCast<PacketSink>(sinkApps.Get(i)));
+        }
+        for (uint32_t i = 0; i < qosApps.GetN(); ++i)
+        {
+            flowDelayProbe->AddFlow(qosApps.Get(i),
+                                    "STA" + std::to_string(i / qosCategories.size()) + "/" +
+                                        qosCategories[i % qosCategories.size()].first);
+        }
+        for (uint32_t c = 0; c < qosSinkApps.GetN(); ++c)
+        {
+            flowDelayProbe->Connect(StaticCast<PacketSink>(qosSinkApps.Get(c)));
+        }
+    }
 
     /* Start Applications */
-    sinkApp.Start(Seconds(0.0));
-    serverApp_0.Start(Seconds(1.0));
-    serverApp_1.Start(Seconds(1.0));
-    Simulator::Schedule(Seconds(1.1), &CalculateThroughput);
+    sinkApps.Start(Seconds(0.0));
+    serverApps.Start(Seconds(1.0));
+    qosSinkApps.Start(Seconds(0.0));
+    qosApps.Start(Seconds(1.0));
+
+    /* Sample the throughput of each station every 100 ms from the sinks' receive traces; the
+     * bytes are attributed to the stations by source address */
+    ThroughputSampler sampler(Seconds(1.0), MilliSeconds(100));
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        sampler.AddFlow(staInterfaces.GetAddress(i), "STA" + std::to_string(i));
+        sampler.Connect(StaticCast<PacketSink>(sinkApps.Get(i)));
+    }
+    std::unique_ptr<ResultWriter> resultWriter;
+    if (!resultsFile.empty() && replications > 1)
+    {
+        std::cout << "The results file is not written when running replications" << std::endl;
+    }
+    else if (!resultsFile.empty())
+    {
+        resultWriter =
+            std::make_unique<ResultWriter>(resultsFile, ResultWriter::GetFormat(resultsFormat));
+        resultWriter->AddMetadata("scenario", "q3");
+        resultWriter->AddMetadata("payloadSize", payloadSize);
+        resultWriter->AddMetadata("dataRate", dataRate);
+        resultWriter->AddMetadata("tcpVariant", tcpVariant);
+        resultWriter->AddMetadata("phyRate", phyRate);
+        resultWriter->AddMetadata("simulationTime", simulationTime);
+        resultWriter->AddMetadata("enableRts", enableRts);
+        resultWriter->AddMetadata("adaptiveRts", adaptiveRts);
+        resultWriter->AddMetadata("qosTraffic", qosTraffic);
+        resultWriter->AddMetadata("enableLargeAmpdu", enableLargeAmpdu);
+        resultWriter->AddMetadata("frequencyBand", frequencyBand);
+        resultWriter->AddMetadata("errorModel", errorModel);
+        resultWriter->AddMetadata("scheduler", scheduler);
+        resultWriter->AddMetadata("traffic", traffic);
+        resultWriter->AddMetadata("leanPackets", leanPackets);
+        resultWriter->AddMetadata("distance", distance);
+        resultWriter->AddMetadata("nStations", nStations);
+        resultWriter->AddMetadata("topology", topology);
+        resultWriter->AddMetadata("run", RngSeedManager::GetRun());
+        AddThroughputColumns(*resultWriter, sampler);
+        sampler.SetBucketCallback([&resultWriter](const ThroughputSampler& s, uint64_t bucket) {
+            WriteThroughputRows(*resultWriter, s, bucket);
+        });
+    }
+    else if (replications <= 1)
+    {
+        sampler.SetBucketCallback(&PrintThroughput);
+    }
+
+    /* Optional stopping rule, chained after the bucket callback set above */
+    std::unique_ptr<ConvergenceMonitor> convergenceMonitor;
+    if (convergence > 0)
+    {
+        ConvergenceMonitor::Config convergenceConfig;
+        convergenceConfig.warmup = Seconds(warmup);
+        convergenceConfig.batch = Seconds(batchLength);
+        convergenceConfig.relativeHalfWidth = convergence;
+        convergenceMonitor = std::make_unique<ConvergenceMonitor>(convergenceConfig);
+        convergenceMonitor->Attach(sampler);
+        if (resultWriter)
+        {
+            resultWriter->AddMetadata("convergence", convergence);
+            resultWriter->AddMetadata("warmup", warmup);
+        }
+    }
+
+    /* Throughput of a station in Mbit/s: the mean of the batch means after the warm-up with the
+     * stopping rule, the average over simulationTime otherwise */
+    auto stationThroughput = [&](uint32_t i) {
+        return convergenceMonitor ? convergenceMonitor->GetSummary(i).mean
+                                  : (sampler.GetTotalBytes(i) * 8) / (1e6 * simulationTime);
+    };
 
     /* Enable Traces */
-    if (pcapTracing)
+    std::unique_ptr<WifiCaptureWriter> captureWriter;
+    if (pcapTracing && replications > 1)
+    {
+        std::cout << "PCAP tracing is disabled when running replications" << std::endl;
+    }
+    else if (pcapTracing)
     {
-        wifiPhy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
-        wifiPhy.EnablePcap("module2-AccessPoint", apDevice);
-        wifiPhy.EnablePcap("module2-Station_0", sta_0);
-        wifiPhy.EnablePcap("module2-Station_1", sta_1);
+        WifiCaptureWriter::Config captureConfig;
+        captureConfig.snapLength = pcapSnapLength;
+        captureConfig.sampling = pcapSampling;
+        captureConfig.background = pcapBackground;
+        captureWriter = std::make_unique<WifiCaptureWriter>(captureConfig);
+        CaptureStationFilter captureStations(pcapStations);
+        if (captureStations.IncludesAp())
+        {
+            captureWriter->Capture("module2-AccessPoint", apDevice);
+        }
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            if (captureStations.IncludesStation(i))
+            {
+                captureWriter->Capture("module2-Station_" + std::to_string(i),
+                                       NetDeviceContainer(staDevices.Get(i)));
+            }
+        }
     }
 
-    std::cout << "AP: "   << apInterface.GetAddress(0)   << "\n"
-        << "STA0: " << staInterface_0.GetAddress(0) << "\n"
-        << "STA1: " << staInterface_1.GetAddress(0) << "\n"
-    ;
+    std::cout << "AP: " << apInterface.GetAddress(0) << "\n";
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        std::cout << "STA" << i << ": " << staInterfaces.GetAddress(i) << "\n";
+    }
 
     /* Start Simulation */
     Simulator::Stop(Seconds(simulationTime + 1));
+
+    if (replications > 1)
+    {
+        /* Every replication re-seeds the streams created during the setup and simulates in a
+         * forked copy of this process */
+        auto results = RunForkedReplications(
+            replications,
+            RngSeedManager::GetRun(),
+            0,
+            [&]() {
+                int64_t stream = 1;
+                stream += wifiChannel.AssignStreams(channel, stream);
+                stream += wifiHelper.AssignStreams(apDevice, stream);
+                stream += wifiHelper.AssignStreams(staDevices, stream);
+                stream += stack.AssignStreams(networkNodes, stream);
+                stream += server.AssignStreams(networkNodes, stream);
+                for (uint32_t i = 0; i < qosApps.GetN(); ++i)
+                {
+                    stream += qosApps.Get(i)->AssignStreams(stream);
+                }
+            },
+            [&]() {
+                std::vector<double> throughput(nStations);
+                for (uint32_t i = 0; i < nStations; ++i)
+                {
+                    throughput[i] = stationThroughput(i);
+                }
+                return throughput;
+            });
+        Simulator::Destroy();
+
+        for (const auto& result : results)
+        {
+            std::cout << "Run " << result.run << ":";
+            if (result.ok)
+            {
+                for (std::size_t i = 0; i < result.values.size(); ++i)
+                {
+                    std::cout << " STA" << i << " " << result.values[i] << " Mbit/s";
+                }
+                std::cout << std::endl;
+            }
+            else
+            {
+                std::cout << " failed" << std::endl;
+            }
+        }
+        auto summary = SummarizeReplications(results);
+        NS_ABORT_MSG_IF(summary.empty(), "All replications failed");
+        for (std::size_t i = 0; i < summary.size(); ++i)
+        {
+            std::cout << "\nAverage throughput for STA " << i << ": " << summary[i].mean
+                      << " Mbit/s (+/- " << summary[i].halfWidth << " at 95% confidence, "
+                      << summary[i].count << " runs)" << std::endl;
+        }
+        return 0;
+    }
+
+    profile.EndSetup();
     Simulator::Run();
+    profile.EndRun();
+    sampler.Flush(Simulator::Now());
+    if (resultWriter)
+    {
+        resultWriter->Close();
+    }
+    if (captureWriter)
+    {
+        captureWriter->Close();
+        std::cout << "Captured " << captureWriter->GetNRecords() << " frames ("
+                  << captureWriter->GetNSkipped() << " skipped by sampling)" << std::endl;
+    }
+    if (profiling)
+    {
+        profile.Report(std::cout);
+    }
 
+    if (convergenceMonitor)
+    {
+        convergenceMonitor->Print(std::cout);
+    }
+    if (flowDelayProbe)
+    {
+        flowDelayProbe->Flush();
+    }
+    if (delayProbe)
+    {
+        flowDelayProbe->Print(std::cout);
+    }
+    if (qosTraffic)
+    {
+        /* Throughput and delay of each access category, over the flows of every station; the
+         * throughput is averaged up to the end of the run, earlier than simulationTime when the
+         * stopping rule ends it */
+        double seconds = (Simulator::Now() - Seconds(1.0)).GetSeconds();
+        auto printCategory = [&](const std::string& name,
+                                 uint64_t rxBytes,
+                                 const std::vector<uint32_t>& flows) {
+            LatencyHistogram delays = flowDelayProbe->GetDelays(flows[0]);
+            uint64_t sent = 0;
+            uint64_t received = 0;
+            for (uint32_t flow : flows)
+            {
+                if (flow != flows[0])
+                {
+                    delays.Merge(flowDelayProbe->GetDelays(flow));
+                }
+                sent += flowDelayProbe->GetNSent(flow);
+                received += flowDelayProbe->GetNReceived(flow);
+            }
+            auto ms = [](Time value) { return value.GetSeconds() * 1e3; };
+            std::cout << name << ": " << (rxBytes * 8) / (1e6 * seconds)
+                      << " Mbit/s, delay p50/p95/p99/max " << ms(delays.GetQuantile(0.5)) << "/"
+                      << ms(delays.GetQuantile(0.95)) << "/" << ms(delays.GetQuantile(0.99))
+                      << "/" << ms(delays.GetMax()) << " ms, " << received << " of " << sent
+                      << " packets received" << std::endl;
+        };
+        for (std::size_t c = 0; c < qosCategories.size(); ++c)
+        {
+            std::vector<uint32_t> flows;
+            for (uint32_t i = 0; i < nStations; ++i)
+            {
+                flows.push_back(nStations + i * qosCategories.size() + c);
+            }
+            printCategory("AC_" + qosCategories[c].first,
+                          StaticCast<PacketSink>(qosSinkApps.Get(c))->GetTotalRx(),
+                          flows);
+        }
+        std::vector<uint32_t> flows;
+        uint64_t rxBytes = 0;
+        for (uint32_t i = 0; i < nStations; ++i)
+        {
+            flows.push_back(i);
+            rxBytes += sampler.GetTotalBytes(i);
+        }
+        printCategory("AC_BE", rxBytes, flows);
+    }
+    for (uint32_t i = 0; adaptiveRts && i < nStations; ++i)
+    {
+        auto device = StaticCast<WifiNetDevice>(staDevices.Get(i));
+        auto manager = DynamicCast<HiddenNodeRtsWifiManager>(device->GetRemoteStationManager());
+        std::cout << "STA " << i << ": RTS/CTS enabled " << manager->GetNActivations()
+                  << " times" << std::endl;
+    }
 
-    double averageThroughput_0 = ((sink_0->GetTotalRx() * 8) / (1e6 * simulationTime));
-    double averageThroughput_1 = ((sink_1->GetTotalRx() * 8) / (1e6 * simulationTime));
+    std::vector<double> averageThroughput(nStations);
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        averageThroughput[i] = stationThroughput(i);
+    }
 
     Simulator::Destroy();
 
-    std::cout << "\nAverage throughput for STA 0: " << averageThroughput_0 << " Mbit/s" << std::endl;
-    std::cout << "\nAverage throughput for STA 1: " << averageThroughput_1 << " Mbit/s" << std::endl;
+    double aggregateThroughput = 0;
+    for (uint32_t i = 0; i < nStations; ++i)
+    {
+        std::cout << "\nAverage throughput for STA " << i << ": " << averageThroughput[i]
+                  << " Mbit/s" << std::endl;
+        aggregateThroughput += averageThroughput[i];
+    }
+    std::cout << "\nAggregate throughput: " << aggregateThroughput << " Mbit/s" << std::endl;
     return 0;
 }
@@ -0,0 +1,331 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "throughput-baseline.h"
+
+#include "../common/statistics.h"
+
+#include "ns3/abort.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * @param baseline the baseline value
+ * @param tolerance the accepted deviations
+ * @return the deviation accepted from the baseline value
+ */
+double
+GetAllowedDeviation(double baseline, const RegressionTolerance& tolerance)
+{
+    return std::max(tolerance.absolute, tolerance.relative * std::abs(baseline));
+}
+
+/**
+ * @param value a throughput in Mbit/s
+ * @param baseline the baseline throughput in Mbit/s
+ * @return the difference, with the relative one when the baseline is not zero
+ */
+std::string
+FormatDifference(double value, double baseline)
+{
+    std::ostringstream os;
+    os << baseline << " -> " << value << " Mbit/s";
+    if (baseline != 0)
+    {
+        os << " (" << std::showpos << 100 * (value - baseline) / baseline << "%)";
+    }
+    return os.str();
+}
+
+} // namespace
+
+bool
+ThroughputTrace::IsEmpty() const
+{
+    return intervals.empty() && averages.empty();
+}
+
+ThroughputTrace
+ParseThroughputTrace(const std::string& output)
+{
+    const std::string average = "Average throughput";
+    ThroughputTrace trace;
+    std::istringstream stream(output);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.compare(0, average.size(), average) == 0)
+        {
+            /* "Average throughput for STA <i>: <value> Mbit/s" (q3) or
+             * "Average throughput: <value> Mbit/s" (q2) */
+            auto colon = line.find(':', average.size());
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+            std::string station = "STA0";
+            const std::string forSta = " for STA ";
+            if (line.compare(average.size(), forSta.size(), forSta) == 0)
+            {
+                station = "STA" + line.substr(average.size() + forSta.size(),
+                                              colon - average.size() - forSta.size());
+            }
+            std::istringstream value(line.substr(colon + 1));
+            double throughput;
+            if (value >> throughput)
+            {
+                trace.averages[station] = throughput;
+            }
+            continue;
+        }
+
+        /* "<time>s: \t<value> Mbit/s" with an optional " (<station>)" */
+        std::istringstream fields(line);
+        double time;
+        double throughput;
+        std::string unit;
+        if (line.empty() || !std::isdigit(static_cast<unsigned char>(line[0])) ||
+            !(fields >> time) || fields.get() != 's' || fields.get() != ':' ||
+            !(fields >> throughput >> unit) || unit != "Mbit/s")
+        {
+            continue;
+        }
+        std::string station = "STA0";
+        std::string label;
+        if (fields >> label && label.size() > 2 && label.front() == '(' && label.back() == ')')
+        {
+            station = label.substr(1, label.size() - 2);
+        }
+        trace.intervals[station][time] = throughput;
+    }
+    return trace;
+}
+
+ThroughputTrace
+SumStations(const ThroughputTrace& trace)
+{
+    ThroughputTrace total;
+    for (const auto& [station, intervals] : trace.intervals)
+    {
+        for (const auto& [time, value] : intervals)
+        {
+            total.intervals["all"][time] += value;
+        }
+    }
+    for (const auto& [station, value] : trace.averages)
+    {
+        total.averages["all"] += value;
+    }
+    return total;
+}
+
+ThroughputTrace
+GetRecordedAggregate(const ThroughputTrace& trace)
+{
+    ThroughputTrace total;
+    if (!trace.intervals.empty())
+    {
+        total.intervals["all"] = trace.intervals.begin()->second;
+    }
+    if (!trace.averages.empty())
+    {
+        total.averages["all"] = trace.averages.begin()->second;
+    }
+    return total;
+}
+
+std::vector<RegressionCase>
+ReadRegressionCases(const std::string& path)
+{
+    std::ifstream file(path);
+    NS_ABORT_MSG_UNLESS(file, "Cannot open " << path);
+    auto slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+    std::vector<RegressionCase> cases;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        RegressionCase regressionCase;
+        if (!(fields >> regressionCase.name) || regressionCase.name[0] == '#')
+        {
+            continue;
+        }
+        std::string stations;
+        std::string absolute;
+        NS_ABORT_MSG_UNLESS(fields >> regressionCase.baseline >> stations >> absolute >>
+                                regressionCase.scenario,
+                            "Incomplete case '" << line << "' in " << path);
+        NS_ABORT_MSG_UNLESS(stations == "each" || stations == "aggregate",
+                            "Stations of case '" << regressionCase.name
+                                                 << "' must be each or aggregate, not '"
+                                                 << stations << "'");
+        regressionCase.aggregate = stations == "aggregate";
+        if (absolute != "-")
+        {
+            std::istringstream value(absolute);
+            double tolerance;
+            NS_ABORT_MSG_UNLESS(value >> tolerance && value.eof() && tolerance >= 0,
+                                "Tolerance of case '"
+                                    << regressionCase.name
+                                    << "' must be '-' or a non-negative number, not '" << absolute
+                                    << "'");
+            regressionCase.absolute = tolerance;
+        }
+        if (regressionCase.baseline[0] != '/')
+        {
+            regressionCase.baseline = directory + regressionCase.baseline;
+        }
+        std::string argument;
+        while (fields >> argument)
+        {
+            regressionCase.arguments.push_back(argument);
+        }
+        cases.push_back(std::move(regressionCase));
+    }
+    return cases;
+}
+
+std::vector<StationComparison>
+CompareThroughput(const ThroughputTrace& baseline,
+                  const ThroughputTrace& current,
+                  const RegressionTolerance& tolerance)
+{
+    std::vector<std::string> stations;
+    for (const auto& [station, intervals] : baseline.intervals)
+    {
+        stations.push_back(station);
+    }
+    for (const auto& [station, value] : baseline.averages)
+    {
+        if (baseline.intervals.count(station) == 0)
+        {
+            stations.push_back(station);
+        }
+    }
+
+    std::vector<StationComparison> comparisons;
+    for (const auto& station : stations)
+    {
+        StationComparison comparison;
+        comparison.station = station;
+
+        auto baselineAverage = baseline.averages.find(station);
+        if (baselineAverage != baseline.averages.end())
+        {
+            comparison.baselineAverage = baselineAverage->second;
+            auto currentAverage = current.averages.find(station);
+            if (currentAverage == current.averages.end())
+            {
+                comparison.failures.push_back("no average throughput");
+            }
+            else
+            {
+                comparison.currentAverage = currentAverage->second;
+                if (std::abs(comparison.currentAverage - comparison.baselineAverage) >
+                    GetAllowedDeviation(comparison.baselineAverage, tolerance))
+                {
+                    comparison.failures.push_back(
+                        "average " +
+                        FormatDifference(comparison.currentAverage, comparison.baselineAverage));
+                }
+            }
+        }
+
+        auto baselineIntervals = baseline.intervals.find(station);
+        if (baselineIntervals != baseline.intervals.end())
+        {
+            auto currentIntervals = current.intervals.find(station);
+            std::vector<double> differences;
+            double baselineSum = 0;
+            uint32_t missing = 0;
+            for (const auto& [time, value] : baselineIntervals->second)
+            {
+                if (currentIntervals == current.intervals.end() ||
+                    currentIntervals->second.count(time) == 0)
+                {
+                    ++missing;
+                    continue;
+                }
+                differences.push_back(currentIntervals->second.at(time) - value);
+                baselineSum += value;
+            }
+            if (missing > 0)
+            {
+                comparison.failures.push_back(std::to_string(missing) + " of " +
+                                              std::to_string(baselineIntervals->second.size()) +
+                                              " intervals missing");
+            }
+            SampleSummary summary = Summarize(differences, tolerance.confidence);
+            comparison.nIntervals = summary.count;
+            comparison.meanDifference = summary.mean;
+            comparison.halfWidth = summary.halfWidth;
+            double baselineMean = differences.empty() ? 0 : baselineSum / differences.size();
+            if (std::abs(summary.mean) > summary.halfWidth &&
+                std::abs(summary.mean) > GetAllowedDeviation(baselineMean, tolerance))
+            {
+                std::ostringstream os;
+                os << "intervals " << FormatDifference(baselineMean + summary.mean, baselineMean)
+                   << " on average, +/- " << summary.halfWidth << " over " << summary.count
+                   << " intervals";
+                comparison.failures.push_back(os.str());
+            }
+        }
+        comparisons.push_back(std::move(comparison));
+    }
+    return comparisons;
+}
+
+void
+PrintLargestDifferences(std::ostream& os,
+                        const ThroughputTrace& baseline,
+                        const ThroughputTrace& current,
+                        const std::string& station,
+                        std::size_t count)
+{
+    auto baselineIntervals = baseline.intervals.find(station);
+    auto currentIntervals = current.intervals.find(station);
+    if (baselineIntervals == baseline.intervals.end() ||
+        currentIntervals == current.intervals.end())
+    {
+        return;
+    }
+    /* Time, baseline and current throughput */
+    std::vector<std::array<double, 3>> rows;
+    for (const auto& [time, value] : baselineIntervals->second)
+    {
+        auto it = currentIntervals->second.find(time);
+        if (it != currentIntervals->second.end())
+        {
+            rows.push_back({time, value, it->second});
+        }
+    }
+    count = std::min(count, rows.size());
+    std::partial_sort(rows.begin(),
+                      rows.begin() + count,
+                      rows.end(),
+                      [](const auto& a, const auto& b) {
+                          return std::abs(a[2] - a[1]) > std::abs(b[2] - b[1]);
+                      });
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        os << "      " << rows[i][0] << "s: " << FormatDifference(rows[i][2], rows[i][1])
+           << "\n";
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_THROUGHPUT_BASELINE_H
+#define SCRATCH_THROUGHPUT_BASELINE_H
+
+// Throughput recorded in the console output of q2 and q3, and its comparison
+// with a baseline output.
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Throughput printed by a run of q2 or q3.
+ */
+struct ThroughputTrace
+{
+    /// Throughput in Mbit/s of each interval, keyed by its end time in seconds, per station
+    std::map<std::string, std::map<double, double>> intervals;
+    /// Average throughput in Mbit/s per station
+    std::map<std::string, double> averages;
+
+    /**
+     * @return whether the output held no throughput
+     */
+    bool IsEmpty() const;
+};
+
+/**
+ * Parse the console output of q2 or q3: the interval lines
+ * "1.1s: \t26.496 Mbit/s (STA0)" (q3) or "1.1s: \t26.496 Mbit/s" (q2, whose
+ * station is STA0), and the lines "Average throughput for STA 0: 31.3666
+ * Mbit/s" (q3) or "Average throughput: 31.3666 Mbit/s" (q2). Other lines,
+ * such as the build messages of the recorded outputs, are ignored.
+ *
+ * @param output the console output
+ * @return the throughput
+ */
+ThroughputTrace ParseThroughputTrace(const std::string& output);
+
+/**
+ * Sum the throughput of every station, interval by interval, into a single
+ * station labelled "all".
+ *
+ * @param trace the per-station throughput
+ * @return the aggregate throughput
+ */
+ThroughputTrace SumStations(const ThroughputTrace& trace);
+
+/**
+ * Read the aggregate throughput of a recording whose every station line
+ * holds the total of all stations, e.g. the q3 outputs recorded before each
+ * station had its own sink. The lines of the first station are labelled
+ * "all"; the others repeat them.
+ *
+ * @param trace the throughput parsed from the recording
+ * @return the aggregate throughput
+ */
+ThroughputTrace GetRecordedAggregate(const ThroughputTrace& trace);
+
+/**
+ * One recorded configuration: a run of a scenario and the output it must reproduce.
+ */
+struct RegressionCase
+{
+    std::string name;                   //!< Name of the case
+    std::string baseline;               //!< Path of the recorded output
+    bool aggregate{false};              //!< Whether the recording holds the total of all stations
+    std::optional<double> absolute;     //!< Absolute tolerance in Mbit/s, if not the default
+    std::string scenario;               //!< Scenario, q2 or q3
+    std::vector<std::string> arguments; //!< Arguments of the scenario
+};
+
+/**
+ * Read a list of cases, one per line: name, path of the recorded output
+ * (relative to the list), the stations of the recording ("each" when every
+ * station was recorded on its own, "aggregate" when every station line holds
+ * the total), the absolute tolerance in Mbit/s ("-" for the default one),
+ * scenario and its arguments, separated by blanks. Empty lines and lines
+ * starting with '#' are skipped.
+ *
+ * @param path the path of the list
+ * @return the cases
+ */
+std::vector<RegressionCase> ReadRegressionCases(const std::string& path);
+
+/**
+ * Accepted deviations from a baseline.
+ */
+struct RegressionTolerance
+{
+    double relative{0.05};   //!< Deviation accepted relative to the baseline
+    double absolute{0.1};    //!< Deviation in Mbit/s accepted in any case
+    double confidence{0.99}; //!< Confidence level of the interval comparison
+};
+
+/**
+ * Difference between a run and its baseline for one station.
+ */
+struct StationComparison
+{
+    std::string station;               //!< Station label
+    double baselineAverage{0};         //!< Average throughput of the baseline in Mbit/s
+    double currentAverage{0};          //!< Average throughput of the run in Mbit/s
+    uint32_t nIntervals{0};            //!< Intervals present in both
+    double meanDifference{0};          //!< Mean difference over these intervals in Mbit/s
+    double halfWidth{0};               //!< Half width of the confidence interval of the difference
+    std::vector<std::string> failures; //!< Reasons why the station regressed, empty if it passed
+};
+
+/**
+ * Compare a run with its baseline, station by station.
+ *
+ * The average throughput fails when it deviates from the baseline by more
+ * than the tolerance, max(absolute, relative * baseline). The intervals are
+ * compared through their paired differences: they fail when the Student t
+ * confidence interval of the mean difference excludes zero and the mean
+ * difference exceeds the tolerance of the mean interval throughput, i.e. when
+ * the time series differ significantly and materially. Consecutive intervals
+ * of one run are correlated, so the interval is narrower than it should be;
+ * the tolerance keeps that from failing identical models. Stations or
+ * intervals missing from the run also fail.
+ *
+ * @param baseline the recorded throughput
+ * @param current the throughput of the run
+ * @param tolerance the accepted deviations
+ * @return one comparison per station of the baseline
+ */
+std::vector<StationComparison> CompareThroughput(const ThroughputTrace& baseline,
+                                                 const ThroughputTrace& current,
+                                                 const RegressionTolerance& tolerance);
+
+/**
+ * Print the intervals whose throughput differs the most between a baseline and a run.
+ *
+ * @param os the output stream
+ * @param baseline the recorded throughput
+ * @param current the throughput of the run
+ * @param station the station label
+ * @param count the number of intervals printed
+ */
+void PrintLargestDifferences(std::ostream& os,
+                             const ThroughputTrace& baseline,
+                             const ThroughputTrace& current,
+                             const std::string& station,
+                             std::size_t count);
+
+} // namespace ns3
+
+#endif /* SCRATCH_THROUGHPUT_BASELINE_H */
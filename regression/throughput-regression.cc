@@ -0,0 +1,253 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Throughput regression gate for the q2 and q3 scenarios.
+//
+// Every case of the list (cases.txt by default) names an output recorded in
+// outputs/ and the scenario arguments that produced it. Recordings whose
+// station lines all hold the total of the stations are marked "aggregate";
+// the sum of the stations of the new run is compared with them. A case may
+// set its own absolute tolerance, e.g. for recordings far below --absolute.
+// The cases are re-run in parallel, one child process per core, with fixed
+// seeds (RngSeed=1, RngRun=1) and without pcap tracing. The average and
+// per-interval throughput of each station is parsed from the recorded and the
+// new output and compared within the tolerances (see CompareThroughput()).
+// Failing stations are reported with the intervals that differ the most, and
+// the exit code is 1 if any case regressed or failed to run.
+//
+//   ./ns3 run "throughput-regression"
+//   ./ns3 run "throughput-regression --relative=0.1 --export=regression.csv"
+//
+// --export writes the parsed baselines next to the new results, one CSV row
+// per station and interval (with an empty time for the averages):
+//
+//   case,station,time,baselineMbps,currentMbps
+
+#include "throughput-baseline.h"
+
+#include "../common/process-pool.h"
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("ThroughputRegression");
+
+namespace
+{
+
+/**
+ * Read a whole file.
+ *
+ * @param path the path of the file
+ * @return its content
+ */
+std::string
+ReadFile(const std::string& path)
+{
+    std::ifstream file(path);
+    NS_ABORT_MSG_UNLESS(file, "Cannot open " << path);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * Write the baseline and the current throughput of a case.
+ *
+ * @param os the CSV output
+ * @param name the name of the case
+ * @param baseline the recorded throughput
+ * @param current the throughput of the run
+ */
+void
+ExportCase(std::ostream& os,
+           const std::string& name,
+           const ThroughputTrace& baseline,
+           const ThroughputTrace& current)
+{
+    for (const auto& [station, intervals] : baseline.intervals)
+    {
+        auto currentIntervals = current.intervals.find(station);
+        for (const auto& [time, value] : intervals)
+        {
+            os << name << "," << station << "," << time << "," << value << ",";
+            if (currentIntervals != current.intervals.end() &&
+                currentIntervals->second.count(time) > 0)
+            {
+                os << currentIntervals->second.at(time);
+            }
+            os << "\n";
+        }
+    }
+    for (const auto& [station, value] : baseline.averages)
+    {
+        os << name << "," << station << ",," << value << ",";
+        auto currentAverage = current.averages.find(station);
+        if (currentAverage != current.averages.end())
+        {
+            os << currentAverage->second;
+        }
+        os << "\n";
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::string casesFile = "scratch/regression/cases.txt"; /* List of the cases */
+    std::string only; /* Comma separated names of the cases to run, all if empty */
+    double relative = 0.05; /* Deviation accepted relative to the baseline */
+    double absolute = 0.1; /* Deviation in Mbit/s accepted in any case */
+    double confidence = 0.99; /* Confidence level of the interval comparison */
+    unsigned jobs = 0; /* Concurrent runs, 0 for one per core */
+    std::string programDirectory; /* Directory of the scenario executables */
+    std::string exportFile; /* CSV file for the baselines and the new results */
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("cases",
+                 "List of the cases: name, recorded output, scenario and arguments per line",
+                 casesFile);
+    cmd.AddValue("only", "Comma separated names of the cases to run (all if empty)", only);
+    cmd.AddValue("relative", "Deviation accepted relative to the baseline", relative);
+    cmd.AddValue("absolute",
+                 "Deviation in Mbit/s accepted in any case, unless the case sets its own",
+                 absolute);
+    cmd.AddValue("confidence",
+                 "Confidence level of the comparison of the interval throughput",
+                 confidence);
+    cmd.AddValue("jobs", "Number of concurrent runs (0 for one per core)", jobs);
+    cmd.AddValue("programDirectory",
+                 "Directory of the q2 and q3 executables (found automatically if empty)",
+                 programDirectory);
+    cmd.AddValue("export", "CSV file for the parsed baselines and the new results", exportFile);
+    cmd.Parse(argc, argv);
+
+    std::vector<RegressionCase> cases;
+    for (auto& regressionCase : ReadRegressionCases(casesFile))
+    {
+        if (only.empty() || ("," + only + ",").find("," + regressionCase.name + ",") !=
+                                std::string::npos)
+        {
+            cases.push_back(std::move(regressionCase));
+        }
+    }
+    NS_ABORT_MSG_IF(cases.empty(), "No case to run");
+
+    std::map<std::string, std::string> programs;
+    std::vector<std::vector<std::string>> commands;
+    std::vector<ThroughputTrace> baselines;
+    for (const auto& regressionCase : cases)
+    {
+        std::string& program = programs[regressionCase.scenario];
+        if (program.empty())
+        {
+            program = programDirectory.empty()
+                          ? GetSiblingExecutable("throughput-regression",
+                                                 regressionCase.scenario,
+                                                 "..")
+                          : programDirectory + "/" + regressionCase.scenario;
+            NS_ABORT_MSG_IF(program.empty() || access(program.c_str(), X_OK) != 0,
+                            "Cannot execute the " << regressionCase.scenario << " scenario '"
+                                                  << program << "', use --programDirectory");
+        }
+        std::vector<std::string> command{program};
+        command.insert(command.end(),
+                       regressionCase.arguments.begin(),
+                       regressionCase.arguments.end());
+        command.push_back("--pcap=0");
+        command.push_back("--RngSeed=1");
+        command.push_back("--RngRun=1");
+        commands.push_back(std::move(command));
+
+        ThroughputTrace baseline = ParseThroughputTrace(ReadFile(regressionCase.baseline));
+        NS_ABORT_MSG_IF(baseline.IsEmpty(), "No throughput in " << regressionCase.baseline);
+        baselines.push_back(regressionCase.aggregate ? GetRecordedAggregate(baseline) : baseline);
+    }
+
+    std::size_t done = 0;
+    auto results =
+        RunProcessPool(commands, jobs, [&](std::size_t index, const ProcessResult& result) {
+            std::cerr << "[" << ++done << "/" << commands.size() << "] " << cases[index].name
+                      << (result.exitCode == 0 ? " done in " : " FAILED after ")
+                      << result.wallSeconds << " s\n";
+        });
+
+    std::ofstream exported;
+    if (!exportFile.empty())
+    {
+        exported.open(exportFile);
+        NS_ABORT_MSG_UNLESS(exported, "Cannot open " << exportFile);
+        exported << "case,station,time,baselineMbps,currentMbps\n";
+    }
+
+    RegressionTolerance tolerance;
+    tolerance.relative = relative;
+    tolerance.absolute = absolute;
+    tolerance.confidence = confidence;
+    int failures = 0;
+    for (std::size_t i = 0; i < cases.size(); ++i)
+    {
+        ThroughputTrace current = ParseThroughputTrace(results[i].output);
+        if (cases[i].aggregate)
+        {
+            current = SumStations(current);
+        }
+        if (exported.is_open())
+        {
+            ExportCase(exported, cases[i].name, baselines[i], current);
+        }
+        if (results[i].exitCode != 0 || current.IsEmpty())
+        {
+            ++failures;
+            std::cout << "FAIL " << cases[i].name << ": exit code " << results[i].exitCode
+                      << ", output:\n"
+                      << results[i].output << "\n";
+            continue;
+        }
+
+        RegressionTolerance caseTolerance = tolerance;
+        caseTolerance.absolute = cases[i].absolute.value_or(absolute);
+        bool passed = true;
+        std::ostringstream report;
+        for (const auto& comparison : CompareThroughput(baselines[i], current, caseTolerance))
+        {
+            report << "    " << comparison.station << ": " << comparison.baselineAverage
+                   << " -> " << comparison.currentAverage << " Mbit/s, intervals "
+                   << comparison.meanDifference << " +/- " << comparison.halfWidth
+                   << " Mbit/s\n";
+            for (const auto& failure : comparison.failures)
+            {
+                report << "      " << failure << "\n";
+            }
+            if (!comparison.failures.empty())
+            {
+                passed = false;
+                report << "      largest interval differences:\n";
+                PrintLargestDifferences(report, baselines[i], current, comparison.station, 3);
+            }
+        }
+        std::cout << (passed ? "PASS " : "FAIL ") << cases[i].name << " ("
+                  << cases[i].baseline << ")\n"
+                  << report.str();
+        failures += passed ? 0 : 1;
+    }
+
+    std::cout << cases.size() - failures << " of " << cases.size() << " cases passed"
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Parameter sweep driver for the q3 hidden-terminal scenario.
+//
+// Each axis of the grid is given as a comma separated list; the driver runs
+// the q3 executable once per cell of the cartesian product, keeping one child
+// process per core busy, and merges the per-station average throughput of
+// every run into a single CSV table (one row per run and station).
+//
+//   ./ns3 run "q3-sweep --enableRts=0,1 --enableLargeAmpdu=0,1
+//              --distance=5,160 --runs=1:10 --output=hidden.csv"
+
+#include "sweep-grid.h"
+
+#include "../common/process-pool.h"
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/log.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("Q3Sweep");
+
+int
+main(int argc, char* argv[])
+{
+    std::string enableRts = "0,1"; /* RTS/CTS values to sweep */
+    std::string enableLargeAmpdu = "0,1"; /* A-MPDU values to sweep */
+    std::string distance = "160"; /* Station distances in meters */
+    std::string tcpVariant = "TcpNewReno"; /* TCP variants */
+    std::string phyRate = "HtMcs7"; /* Data modes */
+    std::string runs = "1"; /* Run numbers, e.g. 1:10 */
+    std::string frequencyBand = "5GHz"; /* Passed through to q3 */
+    double simulationTime = 10; /* Passed through to q3 */
+    unsigned jobs = 0; /* Concurrent runs, 0 for one per core */
+    std::string program; /* Path of the q3 executable */
+    std::string output; /* CSV file, standard output if empty */
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("enableRts", "RTS/CTS settings to sweep, e.g. 0,1", enableRts);
+    cmd.AddValue("enableLargeAmpdu", "A-MPDU settings to sweep, e.g. 0,1", enableLargeAmpdu);
+    cmd.AddValue("distance", "AP to STA distances in meters, e.g. 5,80,160", distance);
+    cmd.AddValue("tcpVariant", "TCP variants, e.g. TcpNewReno,TcpWestwoodPlus", tcpVariant);
+    cmd.AddValue("phyRate", "Data modes, e.g. HtMcs3,HtMcs7", phyRate);
+    cmd.AddValue("runs", "Run numbers (RngRun), as a list and/or ranges, e.g. 1:10", runs);
+    cmd.AddValue("frequencyBand", "Frequency band used by every run", frequencyBand);
+    cmd.AddValue("simulationTime", "Simulation time in seconds of every run", simulationTime);
+    cmd.AddValue("jobs", "Number of concurrent runs (0 for one per core)", jobs);
+    cmd.AddValue("program", "Path of the q3 executable (found automatically if empty)", program);
+    cmd.AddValue("output", "CSV file for the merged results (standard output if empty)", output);
+    cmd.Parse(argc, argv);
+
+    if (program.empty())
+    {
+        program = GetSiblingExecutable("q3-sweep", "q3", "..");
+    }
+    NS_ABORT_MSG_IF(program.empty() || access(program.c_str(), X_OK) != 0,
+                    "Cannot execute the q3 scenario '" << program << "', use --program");
+
+    SweepGrid grid;
+    grid.enableRts = ParseBoolList("enableRts", enableRts);
+    grid.enableLargeAmpdu = ParseBoolList("enableLargeAmpdu", enableLargeAmpdu);
+    grid.distance = ParseDoubleList("distance", distance);
+    grid.tcpVariant = SplitList(tcpVariant);
+    grid.phyRate = SplitList(phyRate);
+    grid.run = ParseRunList("runs", runs);
+    std::vector<SweepPoint> points = grid.Expand();
+    NS_ABORT_MSG_IF(points.empty(), "The sweep grid is empty");
+
+    std::vector<std::vector<std::string>> commands;
+    commands.reserve(points.size());
+    for (const auto& point : points)
+    {
+        std::vector<std::string> command{program};
+        for (auto& arg : GetScenarioArguments(point))
+        {
+            command.push_back(std::move(arg));
+        }
+        command.push_back("--frequencyBand=" + frequencyBand);
+        command.push_back("--simulationTime=" + std::to_string(simulationTime));
+        commands.push_back(std::move(command));
+    }
+
+    std::size_t done = 0;
+    auto results =
+        RunProcessPool(commands, jobs, [&](std::size_t index, const ProcessResult& result) {
+            std::cerr << "[" << ++done << "/" << commands.size() << "] run " << index
+                      << (result.exitCode == 0 ? " done in " : " FAILED after ")
+                      << result.wallSeconds << " s\n";
+        });
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        NS_ABORT_MSG_UNLESS(file, "Cannot open " << output);
+    }
+    std::ostream& table = output.empty() ? std::cout : file;
+    table << "enableRts,enableLargeAmpdu,distance,tcpVariant,phyRate,run,station,"
+             "throughputMbps\n";
+
+    int failures = 0;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const auto& point = points[i];
+        std::vector<double> throughput = ParseStationThroughput(results[i].output);
+        if (results[i].exitCode != 0 || throughput.empty())
+        {
+            ++failures;
+            std::cerr << "Run " << i << " failed (exit code " << results[i].exitCode
+                      << "), output:\n"
+                      << results[i].output << "\n";
+            continue;
+        }
+        for (std::size_t sta = 0; sta < throughput.size(); ++sta)
+        {
+            table << point.enableRts << "," << point.enableLargeAmpdu << "," << point.distance
+                  << "," << point.tcpVariant << "," << point.phyRate << "," << point.run << ","
+                  << sta << "," << throughput[sta] << "\n";
+        }
+    }
+    table.flush();
+
+    std::cerr << points.size() - failures << " of " << points.size() << " runs succeeded\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "sweep-grid.h"
+
+#include "ns3/abort.h"
+
+#include <cctype>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * @param key the option holding the value, for the error message
+ * @param value a number
+ * @return the number; anything else aborts
+ */
+double
+ParseDouble(const std::string& key, const std::string& value)
+{
+    std::size_t end = 0;
+    double number = 0;
+    try
+    {
+        number = std::stod(value, &end);
+    }
+    catch (const std::logic_error&)
+    {
+        end = 0;
+    }
+    NS_ABORT_MSG_IF(end == 0 || end != value.size(),
+                    "Invalid number '" << value << "' in --" << key);
+    return number;
+}
+
+/**
+ * @param key the option holding the value, for the error message
+ * @param value a run number
+ * @return the run number, checked to fit the RngRun attribute; anything else aborts
+ */
+uint64_t
+ParseRun(const std::string& key, const std::string& value)
+{
+    std::size_t end = 0;
+    uint64_t run = 0;
+    try
+    {
+        // std::stoull() would accept a sign and wrap negative numbers around
+        if (!value.empty() && std::isdigit(static_cast<unsigned char>(value[0])))
+        {
+            run = std::stoull(value, &end);
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        end = 0;
+    }
+    NS_ABORT_MSG_IF(end == 0 || end != value.size(),
+                    "Invalid run number '" << value << "' in --" << key);
+    NS_ABORT_MSG_IF(run > std::numeric_limits<uint32_t>::max(),
+                    "Run number " << value << " in --" << key << " out of range");
+    return run;
+}
+
+} // namespace
+
+std::vector<SweepPoint>
+SweepGrid::Expand() const
+{
+    std::vector<SweepPoint> points;
+    for (bool rts : enableRts)
+    {
+        for (bool ampdu : enableLargeAmpdu)
+        {
+            for (double d : distance)
+            {
+                for (const auto& tcp : tcpVariant)
+                {
+                    for (const auto& mcs : phyRate)
+                    {
+                        for (uint32_t r : run)
+                        {
+                            points.push_back({rts, ampdu, d, tcp, mcs, r});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return points;
+}
+
+std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::vector<bool>
+ParseBoolList(const std::string& key, const std::string& list)
+{
+    std::vector<bool> values;
+    for (const auto& item : SplitList(list))
+    {
+        if (item == "1" || item == "true")
+        {
+            values.push_back(true);
+        }
+        else if (item == "0" || item == "false")
+        {
+            values.push_back(false);
+        }
+        else
+        {
+            NS_ABORT_MSG("Invalid boolean '" << item << "' in --" << key << "=" << list);
+        }
+    }
+    return values;
+}
+
+std::vector<double>
+ParseDoubleList(const std::string& key, const std::string& list)
+{
+    std::vector<double> values;
+    for (const auto& item : SplitList(list))
+    {
+        values.push_back(ParseDouble(key, item));
+    }
+    return values;
+}
+
+std::vector<uint32_t>
+ParseRunList(const std::string& key, const std::string& list)
+{
+    std::vector<uint32_t> values;
+    for (const auto& item : SplitList(list))
+    {
+        auto colon = item.find(':');
+        if (colon == std::string::npos)
+        {
+            values.push_back(ParseRun(key, item));
+            continue;
+        }
+        uint64_t first = ParseRun(key, item.substr(0, colon));
+        uint64_t last = ParseRun(key, item.substr(colon + 1));
+        NS_ABORT_MSG_IF(last < first, "Invalid run range '" << item << "' in --" << key);
+        // 64-bit counter, which cannot wrap around when last is the largest run
+        for (uint64_t r = first; r <= last; ++r)
+        {
+            values.push_back(static_cast<uint32_t>(r));
+        }
+    }
+    return values;
+}
+
+std::vector<std::string>
+GetScenarioArguments(const SweepPoint& point)
+{
+    std::ostringstream distance;
+    distance << point.distance;
+    return {"--enableRts=" + std::string(point.enableRts ? "1" : "0"),
+            "--enableLargeAmpdu=" + std::string(point.enableLargeAmpdu ? "1" : "0"),
+            "--distance=" + distance.str(),
+            "--tcpVariant=" + point.tcpVariant,
+            "--phyRate=" + point.phyRate,
+            "--RngRun=" + std::to_string(point.run)};
+}
+
+std::vector<double>
+ParseStationThroughput(const std::string& output)
+{
+    const std::string prefix = "Average throughput for STA ";
+    std::vector<double> throughput;
+    std::istringstream stream(output);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        auto colon = line.find(':', prefix.size());
+        if (colon == std::string::npos)
+        {
+            continue;
+        }
+        std::size_t station;
+        double value;
+        try
+        {
+            station = std::stoul(line.substr(prefix.size(), colon - prefix.size()));
+            value = std::stod(line.substr(colon + 1));
+        }
+        catch (const std::logic_error&)
+        {
+            // Not a throughput line after all
+            continue;
+        }
+        if (throughput.size() <= station)
+        {
+            throughput.resize(station + 1, 0);
+        }
+        throughput[station] = value;
+    }
+    return throughput;
+}
+
+} // namespace ns3
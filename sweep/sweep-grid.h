@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SCRATCH_SWEEP_GRID_H
+#define SCRATCH_SWEEP_GRID_H
+
+// Grid specification for the q3 parameter sweep: every axis is a list of
+// values and the sweep visits their cartesian product.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * One cell of the sweep grid, i.e. one run of the q3 scenario.
+ */
+struct SweepPoint
+{
+    bool enableRts;         //!< RTS/CTS for every frame
+    bool enableLargeAmpdu;  //!< Default A-MPDU limit instead of 4000 bytes
+    double distance;        //!< AP to STA distance in meters
+    std::string tcpVariant; //!< TCP variant, e.g. TcpNewReno
+    std::string phyRate;    //!< Data mode, e.g. HtMcs7
+    uint32_t run;           //!< RngRun value
+};
+
+/**
+ * The axes of the sweep grid.
+ */
+struct SweepGrid
+{
+    std::vector<bool> enableRts;         //!< RTS axis
+    std::vector<bool> enableLargeAmpdu;  //!< A-MPDU axis
+    std::vector<double> distance;        //!< Distance axis
+    std::vector<std::string> tcpVariant; //!< TCP variant axis
+    std::vector<std::string> phyRate;    //!< MCS axis
+    std::vector<uint32_t> run;           //!< Run number axis
+
+    /**
+     * @return every point of the grid, with the run number varying fastest
+     */
+    std::vector<SweepPoint> Expand() const;
+};
+
+/**
+ * Split a comma separated list.
+ *
+ * @param list the list, e.g. "TcpNewReno,TcpVegas"
+ * @return the non-empty items
+ */
+std::vector<std::string> SplitList(const std::string& list);
+
+/**
+ * Parse a list of booleans such as "0,1" or "true,false". Invalid values abort.
+ *
+ * @param key the option holding the list, for the error message
+ * @param list the list
+ * @return the values
+ */
+std::vector<bool> ParseBoolList(const std::string& key, const std::string& list);
+
+/**
+ * Parse a list of numbers such as "5,80,160". Invalid values abort.
+ *
+ * @param key the option holding the list, for the error message
+ * @param list the list
+ * @return the values
+ */
+std::vector<double> ParseDoubleList(const std::string& key, const std::string& list);
+
+/**
+ * Parse run numbers given as a list ("1,4,7"), an inclusive range ("1:10"),
+ * or a mix of both ("1:3,8"). Invalid values abort.
+ *
+ * @param key the option holding the list, for the error message
+ * @param list the list
+ * @return the run numbers
+ */
+std::vector<uint32_t> ParseRunList(const std::string& key, const std::string& list);
+
+/**
+ * Build the q3 command line arguments for a point.
+ *
+ * @param point the grid point
+ * @return the arguments, without the program name
+ */
+std::vector<std::string> GetScenarioArguments(const SweepPoint& point);
+
+/**
+ * Extract the per-station average throughput from the console output of q3.
+ *
+ * @param output the output of the scenario
+ * @return the average throughput of each station in Mbit/s, indexed by station
+ */
+std::vector<double> ParseStationThroughput(const std::string& output);
+
+} // namespace ns3
+
+#endif /* SCRATCH_SWEEP_GRID_H */